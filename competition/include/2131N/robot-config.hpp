@@ -1,12 +1,21 @@
 #pragma once
 
 #include "2131N/systems/chassis.hpp"
+#include "2131N/systems/controller_input.hpp"
 #include "2131N/systems/intake.hpp"
+#include "2131N/systems/match_recorder.hpp"
 #include "2131N/systems/mcl/time_of_flight.hpp"
+#include "2131N/systems/scheduler.hpp"
+#include "2131N/systems/serial_telemetry.hpp"
+#include "2131N/systems/triggers.hpp"
+#include "2131N/ui/field_view.hpp"
 #include "2131N/ui/screen.hpp"
+#include "2131N/utils/drive_curve.hpp"
 #include "systems/mcl/mcl.hpp"
 
 extern pros::Controller primary;
+extern ControllerInput controller_input;
+extern const std::array<DriverProfile, 3> driver_profiles;
 
 extern pros::MotorGroup left_motors;
 extern pros::MotorGroup right_motors;
@@ -26,7 +35,12 @@ extern DistanceSensor right_distance;
 extern DistanceSensor back_distance;
 extern DistanceSensor front_distance;
 
+extern Scheduler scheduler;
 extern Intake intake;
+extern TriggerEngine triggers;
 extern Screen screen;
 
 extern Mcl<800> mcl_localization;
+extern MatchRecorder match_recorder;
+extern SerialTelemetry serial_telemetry;
+extern FieldView field_view;
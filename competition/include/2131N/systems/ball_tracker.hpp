@@ -0,0 +1,227 @@
+/**
+ * @file ball_tracker.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Follows balls through the intake from the bottom detector and stage travel (no pros)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct BallTrackerSettings
+{
+  // Motor travel that carries a ball through the bottom, middle and top stage (deg)
+  std::array<float, 3> stage_travel = {300.0f, 600.0f, 400.0f};
+
+  uint32_t rate_window = 2000;  // Scoring rate is averaged over this long (ms)
+
+  // Shorter reverses (the outtake pulse before scoring) only shuffle balls, none leave (ms)
+  uint32_t eject_delay = 150;
+};
+
+/**
+ * @brief Estimates where every ball in the intake is
+ * @details Balls are added when the bottom detector starts seeing one while the bottom stage
+ * pulls in, then carried along by the travel of the stage they are in. A ball only moves into
+ * the next stage if that stage is turning the same way, so storing (top stage reversed) holds
+ * balls at the top of the middle stage. Balls carried out the top are scored and balls carried
+ * out the bottom are ejected, once the bottom stage has reversed for eject_delay. There is no
+ * sensor at the top, so exits are an estimate that depends on stage_travel.
+ *
+ */
+class BallTracker
+{
+ public:
+  static constexpr size_t kMaxBalls = 16;    // Balls that can be tracked at once
+  static constexpr size_t kStages = 3;       // Bottom, middle and top
+  static constexpr size_t kScoreTimes = 16;  // Score times kept for the rate
+
+ private:
+  struct Ball
+  {
+    uint8_t stage;   // Stage it is in
+    float progress;  // Travel through that stage (deg)
+  };
+
+  BallTrackerSettings settings_;  // Stage lengths and rate window
+
+  std::array<Ball, kMaxBalls> balls_{};  // Balls in the intake
+  size_t count_ = 0;                     // Balls in use
+
+  std::array<uint32_t, kStages> entries_{};  // Balls that have entered each stage
+  std::array<uint32_t, kStages> exits_{};    // Balls that have left each stage (either way)
+  uint32_t scored_ = 0;                      // Balls carried out the top
+  uint32_t ejected_ = 0;                     // Balls carried out the bottom
+  uint32_t lost_ = 0;                        // Entries dropped because the tracker was full
+  uint32_t reversed_at_ = 0;                 // When the bottom stage started reversing (ms)
+  bool reversing_ = false;                   // Bottom stage turned down last update
+
+  std::array<uint32_t, kScoreTimes> score_times_{};  // When the latest balls were scored (ms)
+  size_t score_head_ = 0;                            // Next slot in score_times_
+
+ public:
+  explicit BallTracker(const BallTrackerSettings& settings = {}) : settings_(settings) {}
+
+  /**
+   * @brief A ball reached the bottom detector
+   *
+   */
+  void ballEntered()
+  {
+    if (count_ == kMaxBalls)
+    {
+      lost_++;
+      return;
+    }
+
+    balls_[count_++] = {0, 0.0f};
+    entries_[0]++;
+  }
+
+  /**
+   * @brief Add balls that are already in storage (preloads), at the top of the middle stage
+   *
+   * @param count Balls to add
+   */
+  void addStored(size_t count)
+  {
+    for (size_t i = 0; i < count && count_ < kMaxBalls; i++)
+    {
+      balls_[count_++] = {1, settings_.stage_travel[1]};
+      entries_[1]++;
+    }
+  }
+
+  /**
+   * @brief Move the balls by how far each stage turned
+   *
+   * @param travel Bottom, middle and top stage travel since the last update (deg, + is up)
+   * @param now Current time (ms)
+   */
+  void update(const std::array<float, kStages>& travel, uint32_t now)
+  {
+    bool reversing = travel[0] < 0.0f;
+    if (reversing && !reversing_) { reversed_at_ = now; }
+    reversing_ = reversing;
+    bool ejecting = reversing && now - reversed_at_ >= settings_.eject_delay;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count_; i++)
+    {
+      Ball ball = balls_[i];
+      ball.progress += travel[ball.stage];
+
+      // Into the next stage up, or out the top
+      while (ball.progress > settings_.stage_travel[ball.stage])
+      {
+        if (ball.stage + 1 == kStages)
+        {
+          exits_[ball.stage]++;
+          this->recordScore(now);
+          ball.stage = kStages;
+          break;
+        }
+        if (travel[ball.stage + 1] < 0.0f)
+        {
+          // Next stage is holding balls back
+          ball.progress = settings_.stage_travel[ball.stage];
+          break;
+        }
+        ball.progress -= settings_.stage_travel[ball.stage];
+        exits_[ball.stage]++;
+        entries_[++ball.stage]++;
+      }
+
+      // Into the next stage down, or out the bottom
+      while (ball.stage < kStages && ball.progress < 0.0f)
+      {
+        if (ball.stage == 0 && !ejecting)
+        {
+          // Held at the bottom until the reverse is long enough to be an outtake
+          ball.progress = 0.0f;
+          break;
+        }
+        if (ball.stage == 0)
+        {
+          exits_[0]++;
+          ejected_++;
+          ball.stage = kStages;
+          break;
+        }
+        if (travel[ball.stage - 1] > 0.0f)
+        {
+          ball.progress = 0.0f;
+          break;
+        }
+        exits_[ball.stage]++;
+        entries_[--ball.stage]++;
+        ball.progress += settings_.stage_travel[ball.stage];
+      }
+
+      if (ball.stage < kStages) { balls_[kept++] = ball; }
+    }
+    count_ = kept;
+  }
+
+  /**
+   * @brief Get the balls scored per second over the rate window
+   *
+   * @param now Current time (ms)
+   * @return float Scoring rate (balls/s)
+   */
+  float getScoreRate(uint32_t now) const
+  {
+    size_t recent = 0;
+    for (uint32_t time : score_times_)
+    {
+      if (time != 0 && now - time < settings_.rate_window) { recent++; }
+    }
+    return recent * 1000.0f / settings_.rate_window;
+  }
+
+  /**
+   * @brief Check if a ball is waiting at the top of a stage because the next one holds it back
+   *
+   * @param stage Bottom (0) or middle (1)
+   * @return true A ball is at the end of the stage
+   */
+  bool isHeldBack(size_t stage) const
+  {
+    for (size_t i = 0; i < count_; i++)
+    {
+      if (balls_[i].stage == stage && balls_[i].progress >= settings_.stage_travel[stage])
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  size_t getHeld() const { return count_; }
+  uint32_t getScored() const { return scored_; }
+  uint32_t getEjected() const { return ejected_; }
+  uint32_t getLost() const { return lost_; }
+  uint32_t getEntries(size_t stage) const { return entries_[stage]; }
+  uint32_t getExits(size_t stage) const { return exits_[stage]; }
+
+  /**
+   * @brief Forget every ball (counters are kept)
+   *
+   */
+  void clear() { count_ = 0; }
+
+ private:
+  void recordScore(uint32_t now)
+  {
+    scored_++;
+    score_times_[score_head_] = now == 0 ? 1 : now;
+    score_head_ = (score_head_ + 1) % kScoreTimes;
+  }
+};
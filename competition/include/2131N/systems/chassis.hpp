@@ -11,13 +11,144 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 
+#include "2131N/systems/path.hpp"
+#include "2131N/systems/pose_predictor.hpp"
+#include "2131N/systems/traction_control.hpp"
+#include "2131N/utils/command_cache.hpp"
+#include "2131N/utils/settle_detector.hpp"
+#include "2131N/utils/velocity_controller.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/pose.hpp"
+#include "pros/rtos.hpp"
+
+struct FollowPathParams
+{
+  bool forwards = true;         // Drive the path with the front of the robot
+  float min_lookahead = 8.0f;   // Lookahead distance when stopped (in)
+  float max_lookahead = 16.0f;  // Lookahead distance at full speed (in)
+  float end_tolerance = 1.0f;   // Distance from the last point that ends the motion (in)
+};
 
 class Chassis : public lemlib::Chassis
 {
+ private:
+  enum class MotionType
+  {
+    NONE,        // Motion without a settle check (swings, paths)
+    POINT,       // moveToPoint
+    POSE,        // moveToPose
+    HEADING,     // turnToHeading
+    FACE_POINT,  // turnToPoint
+  };
+
+  struct TrackedMotion
+  {
+    MotionType type = MotionType::NONE;
+    float x = 0.0f;
+    float y = 0.0f;
+    float theta = 0.0f;
+    bool forwards = true;
+    bool settle = false;  // Only motions that come to rest (minSpeed == 0) may exit on settle
+    uint32_t id = 0;
+  };
+
+  TrackedMotion tracked_motion_;  // Motion currently being run by lemlib
+  uint32_t pending_motions_ = 0;  // Motion calls that haven't started yet
+  pros::Mutex tracked_mutex_;     // Guards the tracked motion between tasks
+
+  SettleDetector lateral_settle_;  // Exit condition for lateral error (in)
+  SettleDetector angular_settle_;  // Exit condition for angular error (deg)
+
+  PosePredictor pose_predictor_;  // Forecasts where the chassis is heading
+  pros::Mutex predictor_mutex_;   // Guards the predictor between tasks
+
+  pros::Task monitor_task_;  // Thread that updates the predictor and ends settled motions
+
+  VelocityController left_velocity_;   // Inner velocity loop for the left side (in/s -> mV)
+  VelocityController right_velocity_;  // Inner velocity loop for the right side (in/s -> mV)
+  float left_target_ = 0.0f;           // Commanded left side velocity (in/s)
+  float right_target_ = 0.0f;          // Commanded right side velocity (in/s)
+  bool velocity_control_ = false;      // Is the velocity loop driving the motors
+  pros::Mutex velocity_mutex_;         // Guards the velocity targets between tasks
+  MotorCommand left_command_;          // Left side voltage, only sent when it changes
+  MotorCommand right_command_;         // Right side voltage, only sent when it changes
+  TractionController traction_;        // Limits the targets to what the wheels can grip
+  bool traction_control_ = false;      // Is the traction controller limiting the targets
+
+  pros::Task velocity_task_;  // Thread that runs the velocity loop at the motor update rate
+
  public:
+  /**
+   * @brief Construct a new Chassis
+   *
+   * @param drivetrain lemlib drivetrain
+   * @param lateral_settings Lateral PID and timeout exit settings
+   * @param angular_settings Angular PID and timeout exit settings
+   * @param sensors Odometry sensors
+   * @param lateral_settle Settle exit for moveToPoint / moveToPose
+   * @param angular_settle Settle exit for turns and moveToPose
+   * @param predictor_settings Drivetrain model for pose prediction
+   * @param drive_velocity Velocity controller for each drive side (in/s in, mV out)
+   * @param traction_settings Acceleration and slip limits for the velocity loop
+   */
+  Chassis(
+      lemlib::Drivetrain drivetrain,
+      lemlib::ControllerSettings lateral_settings,
+      lemlib::ControllerSettings angular_settings,
+      lemlib::OdomSensors sensors,
+      SettleSettings lateral_settle,
+      SettleSettings angular_settle,
+      PredictorSettings predictor_settings,
+      VelocityController drive_velocity,
+      TractionSettings traction_settings);
+
+  void moveToPoint(
+      float x, float y, int timeout, lemlib::MoveToPointParams p = {}, bool async = true);
+
+  void moveToPose(
+      float x,
+      float y,
+      float theta,
+      int timeout,
+      lemlib::MoveToPoseParams p = {},
+      bool async = true);
+
+  void turnToHeading(
+      float theta, int timeout, lemlib::TurnToHeadingParams p = {}, bool async = true);
+
+  void turnToPoint(
+      float x, float y, int timeout, lemlib::TurnToPointParams p = {}, bool async = true);
+
+  void swingToHeading(
+      float theta,
+      lemlib::DriveSide locked_side,
+      int timeout,
+      lemlib::SwingToHeadingParams p = {},
+      bool async = true);
+
+  void swingToPoint(
+      float x,
+      float y,
+      lemlib::DriveSide locked_side,
+      int timeout,
+      lemlib::SwingToPointParams p = {},
+      bool async = true);
+
+  void follow(
+      const asset& path, float lookahead, int timeout, bool forwards = true, bool async = true);
+
+  /**
+   * @brief Follow a path with adaptive lookahead pure pursuit
+   *
+   * @param path Path to follow (must outlive the motion when async)
+   * @param timeout Longest time the motion can run (ms)
+   * @param p Follower settings
+   * @param async Run the motion in the background
+   */
+  void followPath(const Path& path, int timeout, FollowPathParams p = {}, bool async = true);
+
   void moveToRelativePose(
       const lemlib::Pose& deltaPose,
       int timeout,
@@ -40,6 +171,136 @@ class Chassis : public lemlib::Chassis
 
   static lemlib::Pose fromPolar(float r, float theta, bool radians = false);
 
+  /**
+   * @brief Predict the pose of the chassis if the current drive commands are held
+   *
+   * @param time Time ahead to predict (ms)
+   * @return lemlib::Pose Predicted pose (degrees)
+   */
+  lemlib::Pose getPredictedPose(float time);
+
+  /**
+   * @brief Predict where the current motion will leave the chassis
+   *
+   * @param end_pose Set to the predicted end pose when the prediction is confident
+   * @return true The chassis is stopped or will settle on the current motion's target
+   * @return false The motion's end can't be predicted yet
+   */
+  bool predictMotionEnd(lemlib::Pose& end_pose);
+
+  /**
+   * @brief Wait until the chassis is predicted to be within a radius of a point
+   *
+   * @param x X position of the point (in)
+   * @param y Y position of the point (in)
+   * @param radius Radius around the point (in)
+   * @param lead_time How far ahead to predict, to cover the latency of the action that follows (ms)
+   * @param timeout Longest time to wait (ms)
+   * @return true The chassis reached the point
+   * @return false The wait timed out or the motion ended first
+   */
+  bool waitUntilNear(float x, float y, float radius, float lead_time = 0, int timeout = 5000);
+
+  /**
+   * @brief Get the distance travelled along the current motion
+   *
+   * @return float Distance (in), -1 if no motion is running
+   */
+  float getDistanceTraveled() const { return distTraveled; }
+
+  /**
+   * @brief Drive each side at a velocity using the inner velocity loop
+   * @details The loop keeps running until a lemlib motion starts or stopDriveVelocity is called
+   *
+   * @param left Left side velocity (in/s)
+   * @param right Right side velocity (in/s)
+   */
+  void setDriveVelocity(float left, float right);
+
+  /**
+   * @brief Turn traction control of the velocity loop on or off (off until opcontrol turns it on)
+   *
+   * @param enabled Limit how fast the targets change to what the wheels can grip
+   */
+  void setTractionControl(bool enabled);
+
+  /**
+   * @brief Stop the velocity loop and the drive motors
+   *
+   */
+  void stopDriveVelocity();
+
+  /**
+   * @brief Tank drive through the velocity loop with outputs that are already shaped
+   *
+   * @param left Left output (-127 to 127), 127 is full speed
+   * @param right Right output (-127 to 127)
+   */
+  void tank(float left, float right);
+
+  /**
+   * @brief Tank drive through the velocity loop, full stick is full speed
+   *
+   * @param left_speed Left stick (-127 to 127)
+   * @param right_speed Right stick (-127 to 127)
+   * @param dead_zone Stick values below this are treated as 0
+   * @param drive_curve Apply the lemlib throttle curve
+   */
   void tank_with_dead_zone(
       double left_speed, double right_speed, double dead_zone, bool drive_curve = false);
+
+ private:
+  /**
+   * @brief Mark that a motion call is about to request the chassis
+   *
+   */
+  void beginMotion();
+
+  /**
+   * @brief Record the motion that lemlib just started
+   *
+   * @param motion Target of the motion
+   */
+  void trackMotion(TrackedMotion motion);
+
+  /**
+   * @brief Wait until the current motion's end pose is known
+   *
+   * @return lemlib::Pose The predicted (or reached) end pose
+   */
+  lemlib::Pose getMotionEndPose();
+
+  /**
+   * @brief Feed the pose predictor the latest chassis state
+   *
+   */
+  void updatePrediction();
+
+  /**
+   * @brief End the current motion once the settle detectors agree
+   *
+   * @param watched_id Id of the motion the detectors were last reset for
+   */
+  void checkSettle(uint32_t& watched_id);
+
+  /**
+   * @brief Run one step of the velocity loop on both drive sides
+   *
+   */
+  void updateDriveVelocity();
+
+  /**
+   * @brief Get the average velocity of a drive side
+   *
+   * @param motors Motors on the side
+   * @return float Side velocity (in/s)
+   */
+  float getSideVelocity(pros::MotorGroup* motors);
+
+  /**
+   * @brief Get the forward acceleration from the IMU
+   *
+   * @return float Acceleration including the IMU's offset (in/s^2), 0 without an IMU
+   */
+  float getForwardAccel();
 };
@@ -0,0 +1,94 @@
+/**
+ * @file controller_input.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Samples the controller once per tick and publishes the buttons and sticks as a snapshot
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "2131N/utils/double_buffer.hpp"
+#include "pros/misc.h"
+#include "pros/misc.hpp"
+
+/**
+ * @brief Every button and stick on the controller at one moment
+ *
+ */
+struct ControllerSnapshot
+{
+  static constexpr int kButtons = pros::E_CONTROLLER_DIGITAL_A - pros::E_CONTROLLER_DIGITAL_L1 + 1;
+
+  uint32_t time = 0;               // When it was sampled (ms)
+  uint32_t sequence = 0;           // Samples taken before this one
+  std::array<int8_t, 4> analog{};  // Left X, left Y, right X and right Y (-127 to 127)
+  uint16_t held = 0;               // Buttons down, one bit per button from L1
+  uint16_t pressed = 0;            // Buttons that went down since the last sample
+  uint16_t released = 0;           // Buttons that came up since the last sample
+
+  /**
+   * @brief Get a button's bit in held, pressed and released
+   *
+   * @param button Button
+   * @return uint16_t Bit mask
+   */
+  static constexpr uint16_t bit(pros::controller_digital_e_t button)
+  {
+    return static_cast<uint16_t>(1u << (button - pros::E_CONTROLLER_DIGITAL_L1));
+  }
+
+  bool isHeld(pros::controller_digital_e_t button) const { return held & bit(button); }
+  bool isPressed(pros::controller_digital_e_t button) const { return pressed & bit(button); }
+  bool isReleased(pros::controller_digital_e_t button) const { return released & bit(button); }
+  int8_t getAnalog(pros::controller_analog_e_t channel) const { return analog[channel]; }
+};
+
+/**
+ * @brief Reads the controller in one place so the driver code and subsystems see the same input
+ * @details get_digital_new_press keeps its own edge state, so every caller polling it for the
+ * same button sees a different answer. Here the controller is read once per tick, edges come
+ * from the previous sample, and the snapshot is published for other tasks to copy. Only one
+ * task should call update().
+ *
+ */
+class ControllerInput
+{
+ public:
+  static constexpr uint32_t kPeriod = 10;  // Controller data refresh rate (ms)
+
+ private:
+  pros::Controller* controller_;  // Controller to sample
+
+  ControllerSnapshot last_;                     // Latest sample (sampling task only)
+  DoubleBuffer<ControllerSnapshot> published_;  // Latest sample for other tasks
+
+ public:
+  /**
+   * @brief Construct a new Controller Input
+   *
+   * @param controller Controller to sample
+   */
+  explicit ControllerInput(pros::Controller* controller) : controller_(controller) {}
+
+  /**
+   * @brief Sample the controller and publish the snapshot
+   *
+   * @return const ControllerSnapshot& New snapshot, valid until the next update
+   */
+  const ControllerSnapshot& update();
+
+  /**
+   * @brief Copy the latest published snapshot (any task)
+   * @details Edges only cover one tick, a task copying less often than that can miss them.
+   *
+   * @return ControllerSnapshot Snapshot
+   */
+  ControllerSnapshot get() const;
+};
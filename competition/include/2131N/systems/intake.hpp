@@ -11,7 +11,16 @@
 
 #pragma once
 
+#include <array>
+
+#include "2131N/systems/ball_tracker.hpp"
+#include "2131N/systems/controller_input.hpp"
+#include "2131N/systems/intake_machine.hpp"
+#include "2131N/systems/jam_detector.hpp"
+#include "2131N/systems/telemetry.hpp"
 #include "2131N/utils/change_detector.hpp"
+#include "2131N/utils/command_cache.hpp"
+#include "2131N/utils/velocity_controller.hpp"
 #include "main.h"
 #include "pros/abstract_motor.hpp"
 #include "pros/adi.hpp"
@@ -19,7 +28,7 @@
 #include "pros/misc.h"
 #include "pros/motors.hpp"
 #include "pros/motor_group.hpp"
-
+#include "pros/rtos.hpp"
 
 class Intake
 {
@@ -34,13 +43,14 @@ class Intake
   pros::adi::Pneumatics* middle_stage_gate_;  // Middle stage gate
   // pros::adi::Pneumatics* first_stage_lift;
 
+  std::array<MotorCommand, 3> stage_commands_;  // Bottom, middle and top stage commands
+  PneumaticCommand middle_gate_command_;        // Middle gate writes, only sent when they change
+
   pros::Distance* bottom_detector_;  // Pointer to the bottom stage detector
   float detection_range_;            // Anything less than this number will be counted as detected
   bool ball_detected_ = false;       // Is the detector reading a ball
   ChangeDetector<bool> ball_detector;
 
-  pros::Controller* primary_;  // Controller (for tele-op)
-
   pros::controller_digital_e_t
       intake_button_;  // Intake Button (Spins Top and Bottom Stage to cycle ball up)
   pros::controller_digital_e_t
@@ -50,26 +60,24 @@ class Intake
   pros::controller_digital_e_t
       score_middle_button;  // Unstore Button (Spins Storage out to remove stored balls)
 
-  pros::Task update_thread_;
+  IntakeMachine machine_;      // States, transitions and per-state voltages (intake_machine.hpp)
+  BallTracker ball_tracker_;   // Estimated balls in each stage
+  pros::Mutex machine_mutex_;  // Guards the machine and the tracker between tasks
 
-  bool score_mode_ = false;
-  bool score_middle_ = false;
-  bool anti_jam_ = false;
-  size_t jam_loop_ = 0;
+  std::array<double, 3> last_positions_{};  // Stage positions at the last update (deg)
+
+  JamSettings jam_settings_;                   // Stall thresholds and the unjam sequence
+  std::array<JamDetector, 3> jam_detectors_;  // Bottom, middle and top stage stall detection
+  bool jam_detection_ = true;                  // Unjam automatically while pulling balls in
+
+  std::array<VelocityController, 3> stage_velocity_;  // Stage velocity loops (rpm -> mV)
+  std::array<int32_t, 3> stage_targets_{};            // Last target per stage (mV or rpm)
+  bool closed_loop_ = true;                           // Use the states' velocity targets
 
   double intake_multipliers[3] = {1.0, 1.0, 1.0};
 
  public:
-  enum class states
-  {
-    STOPPED,
-    OUTTAKE,
-    OUTTAKEMIDDLE,
-    STORING,
-    SCORING,
-    SCORE_MIDDLE,
-    STORE_TOP
-  } state;
+  using states = IntakeState;
 
  public:
   Intake(
@@ -79,235 +87,126 @@ class Intake
       pros::Distance* bottom_detector,
       pros::adi::Pneumatics* middle_gate,
       float detection_range,
-      pros::Controller* primary,
       pros::controller_digital_e_t intake_button,
       pros::controller_digital_e_t outtake_button,
       pros::controller_digital_e_t score_top_button,
-      pros::controller_digital_e_t score_middle_button)
-      : bottom_stage_(bottom_stage),
-        middle_stage_(middle_stage),
-        top_stage_(top_stage),
-        middle_stage_gate_(middle_gate),
-        bottom_detector_(bottom_detector),
-        detection_range_(detection_range),
-        primary_(primary),
-        intake_button_(intake_button),
-        outtake_button_(outtake_button),
-        score_top_button_(score_top_button),
-        score_middle_button(score_middle_button),
-        update_thread_(
-            [this]() {
-              while (true)
-              {
-                this->update();
-                pros::delay(10);
-              }
-            },
-            "Intake Update")
-  {
-  }
-
-
-    
-
-  // void teleOp()
-  // {
-  //   if (primary_->get_digital_new_press(intake_button_))
-  //   {
-  //     if (score_middle_) { setState(states::SCORE_MIDDLE); }
-  //     else if (score_mode_) { setState(states::SCORING); }
-  //     else { setState(states::STORING); }
-  //   }
-  //   // else if (primary_->get_digital_new_press(outtake_button_)) { setState(states::OUTTAKE); }
-  //   //else if (primary_->get_digital_new_press(outtake_button_) && score_middle_){ setState(states::OUTTAKEMIDDLE); }
-  //   else if (primary_->get_digital_new_press(outtake_button_)) { setState(states::OUTTAKE); }
-
-  //   else if (
-  //       primary_->get_digital_new_release(intake_button_) ||
-  //       primary_->get_digital_new_release(outtake_button_)
-
-  //   )
-  //   {
-  //     setState(states::STOPPED);
-  //   }
-
-  //   if (primary_->get_digital_new_press(score_top_button_))
-  //   {
-  //     score_middle_ = false;
-  //     middle_stage_gate_->set_value(score_middle_);
-
-  //     score_mode_ = !score_mode_;
-  //     if (primary_->get_digital(intake_button_))
-  //     {
-  //       if (score_middle_) { setState(states::SCORE_MIDDLE); }
-  //       else if (score_mode_) { setState(states::SCORING); }
-  //       else
-  //       {
-  //         setState(states::STORING);
-  //         middle_stage_->brake();
-  //       }
-  //     }
-  //   }
-  //   else if (primary_->get_digital_new_press(score_middle_button))
-  //   {
-  //     score_middle_ = !score_middle_;
-
-  //     middle_stage_gate_->set_value(score_middle_);
-
-  //     if (score_middle_ == false) { score_mode_ = false; }
-  //     if (primary_->get_digital(intake_button_))
-  //     {
-  //       if (score_middle_) { setState(states::SCORE_MIDDLE); }
-  //       else if (score_mode_) { setState(states::SCORING); }
-  //       else
-  //       {
-  //         setState(states::STORING);
-  //         middle_stage_->brake();
-  //       }
-  //     }
-      
-  //   }
-    
-  // }
-
-
-
-
-
-void teleOp()
-  {
-    if (primary_->get_digital_new_press(intake_button_))
-    {
-        //topIntakeSpeed = 12000;
-        if (score_mode_) { setState(states::SCORING); }
-        else { setState(states::STORING); }
-    }
-    
-    else if (primary_->get_digital_new_press(outtake_button_)) { 
-      //topIntakeSpeed = 12000;
-      setState(states::OUTTAKE); 
-    }
-
-    else if (
-      //topIntakeSpeed = 12000;
-        primary_->get_digital_new_release(intake_button_) ||
-        primary_->get_digital_new_release(outtake_button_)
-
-    )
-    {
-      setState(states::STOPPED);
-    }
-
-      if (primary_->get_digital_new_press(score_top_button_))
-    {
-      // if(scoreSpeedPressed){
-      //   topIntakeSpeed = 4000;
-      // }
-      // else{
-      //   topIntakeSpeed = 4000;
-      // }
-      score_mode_ = !score_mode_;
-      if (primary_->get_digital(intake_button_))
-      {
-         if (score_mode_) { setState(states::SCORING); }
-         else
-        {
-          setState(states::STORING);
-          middle_stage_->brake();
-        }
-      }
-    }
-  }
-
-
-  void setState(states new_state) { state = new_state; }
-  void setMiddle(bool v) { middle_stage_gate_->set_value(v); }
+      pros::controller_digital_e_t score_middle_button,
+      VelocityController stage_velocity,
+      const JamSettings& jam_settings = {},
+      const BallTrackerSettings& ball_settings = {});
+
+  /**
+   * @brief Turn the driver's buttons into state machine events
+   *
+   * @param input Controller snapshot for this tick
+   */
+  void teleOp(const ControllerSnapshot& input);
+
+  /**
+   * @brief Go straight to a state
+   *
+   * @param new_state State
+   */
+  void setState(states new_state);
+
+  /**
+   * @brief Get the current state
+   *
+   * @return states State
+   */
+  states getState();
+
+  bool isBallDetected() const { return ball_detected_; }
+  void setMiddle(bool v) { middle_gate_command_.set(v); }
   void setIntakeMultiplier(double scale1, double scale2, double scale3) { this->intake_multipliers[0] = scale1; this->intake_multipliers[1] = scale2; this->intake_multipliers[2] = scale3; }
-  void antiJam(bool anti_jam)
-  {
-    anti_jam_ = anti_jam;
-    jam_loop_ = 0;
-  }
+
+  /**
+   * @brief Reverse the bottom and middle stages for a moment, then carry on as before
+   *
+   * @param anti_jam Start reversing, false stops early
+   */
+  void antiJam(bool anti_jam);
+
+  /**
+   * @brief Get the estimated number of balls in the intake
+   *
+   * @return size_t Balls held
+   */
+  size_t getHeld();
+
+  /**
+   * @brief Get the estimated number of balls scored out the top since the program started
+   *
+   * @return uint32_t Balls scored
+   */
+  uint32_t getScored();
+
+  /**
+   * @brief Get the scoring rate over the last couple of seconds
+   *
+   * @return float Balls per second
+   */
+  float getScoreRate();
+
+  /**
+   * @brief Tell the tracker about balls the detector never saw (preloads)
+   *
+   * @param count Balls in storage
+   */
+  void addStored(size_t count);
+
+  /**
+   * @brief Wait until more balls have been scored
+   *
+   * @param count Balls to score from now
+   * @param timeout Longest time to wait (ms)
+   * @return true They were scored
+   * @return false Timed out
+   */
+  bool waitUntilScored(uint32_t count, uint32_t timeout);
+
+  /**
+   * @brief Wait until the intake is estimated to be empty
+   *
+   * @param timeout Longest time to wait (ms)
+   * @return true The intake emptied
+   * @return false Timed out
+   */
+  bool waitUntilEmpty(uint32_t timeout);
+
+  /**
+   * @brief Turn automatic jam detection on or off
+   *
+   * @param enabled Unjam automatically while pulling balls in
+   */
+  void setJamDetection(bool enabled) { jam_detection_ = enabled; }
+
+  /**
+   * @brief Drive stages at the states' velocity targets, or fall back to the open loop voltages
+   *
+   * @param enabled Use the velocity loops
+   */
+  void setClosedLoop(bool enabled) { closed_loop_ = enabled; }
+
+  /**
+   * @brief Run the state machine and drive the stages, run every 10ms by the scheduler
+   *
+   */
+  void update();
 
  private:
-  void update()
-  {
-    ball_detected_ = (bottom_detector_->get() < detection_range_);
-    ball_detector.checkValue(ball_detected_);
-
-    if (this->anti_jam_)
-    {
-      jam_loop_++;
-      bottom_stage_->move_voltage(-12000);
-      middle_stage_->move_voltage(-8000);
-      if (jam_loop_ > 10) { this->antiJam(false); }
-    }
-    else
-    {
-      switch (state)
-      {
-        case states::STORING:
-
-          // bottom_stage_->move_voltage(12000 * this->intake_multiplier_);
-          // top_stage_->move_voltage(-1000 * this->intake_multiplier_);
-          // if (ball_detector.getValue())
-          // {
-          //   middle_stage_->set_encoder_units_all(pros::MotorEncoderUnits::deg);
-          //   middle_stage_->move_velocity(150 * this->intake_multiplier_);
-          //   if (std::abs(middle_stage_->get_torque()) > 0.9)
-          //   {
-          //     middle_stage_->set_brake_mode_all(pros::MotorBrake::coast);
-          //     middle_stage_->brake();
-          //   }
-          // }
-          // else { middle_stage_->brake(); }
-          bottom_stage_->move_voltage(12000 * intake_multipliers[0]);
-          middle_stage_->move_voltage(12000 * intake_multipliers[1]);
-          top_stage_->move_voltage(-12000 * intake_multipliers[2]); //-5000
-          break;
-        case states::SCORE_MIDDLE:
-
-          // TODO: Add reversing behavior
-          // bottom_stage_->move_voltage(12000 * intake_multiplier_);
-          // middle_stage_->move_voltage(6000 * intake_multiplier_);
-          // top_stage_->move_voltage(12000 * intake_multiplier_);
-          break;
-        case states::OUTTAKE: 
-
-          bottom_stage_->move_voltage(-12000 * intake_multipliers[0]);
-          middle_stage_->move_voltage(-8000 * intake_multipliers[1]);
-          top_stage_->move_voltage(-12000 * intake_multipliers[2]);
-          // first_stage_lift->extend();
-          break;
-        case states::OUTTAKEMIDDLE:
-
-          bottom_stage_->move_voltage(12000 * intake_multipliers[0]);
-          middle_stage_->move_voltage(12000 * intake_multipliers[1]);
-          top_stage_->move_voltage(3000 * intake_multipliers[2]);
-          // first_stage_lift->extend();
-          break;
-        case states::SCORING:
-
-          bottom_stage_->move_voltage(12000 * intake_multipliers[0]);
-          middle_stage_->move_voltage(12000 * intake_multipliers[1]);
-          top_stage_->move_voltage(12000 * intake_multipliers[2]);
-          break;
-        case states::STOPPED:
-          bottom_stage_->set_brake_mode_all(pros::MotorBrake::coast);
-          middle_stage_->set_brake_mode_all(pros::MotorBrake::coast);
-          top_stage_->set_brake_mode_all(pros::MotorBrake::coast);
-
-          bottom_stage_->brake();
-          middle_stage_->brake();
-          top_stage_->brake();
-          break;
-
-        case states::STORE_TOP:
-          bottom_stage_->move_voltage(12000 * intake_multipliers[0]);
-          middle_stage_->move_voltage(12000 * intake_multipliers[1]);
-          top_stage_->move_voltage(-1500 * intake_multipliers[2]);
-          break;
-      }
-    }
-  }
-};
\ No newline at end of file
+  /**
+   * @brief Send an event to the state machine
+   *
+   * @param event Event
+   */
+  void post(IntakeEvent event);
+
+  /**
+   * @brief Check the watched stages for a stall, and start unjamming if one has
+   *
+   * @param now Current time (ms)
+   * @param watched Bottom, middle and top stage are checked (IntakeMachine::checksJams)
+   */
+  void checkJams(uint32_t now, const std::array<bool, 3>& watched);
+};
@@ -0,0 +1,424 @@
+/**
+ * @file intake_machine.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Table-driven hierarchical state machine for the intake (no pros, runs on the host too)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+enum class IntakeState : uint8_t
+{
+  STOPPED,        // Stages coasting
+  OUTTAKE,        // Everything out the bottom
+  OUTTAKEMIDDLE,  // Bottom and middle in, top slowly out the middle
+  STORING,        // Bottom and middle in, top holding balls in storage
+  SCORING,        // Everything in and out the top
+  SCORE_MIDDLE,   // Not tuned yet, the stages are left alone
+  STORE_TOP,      // Bottom and middle in, top barely holding
+  ANTI_JAM,       // Running the unjam sequence, then back to the state before
+
+  RUNNING,    // Superstate of the states pulling balls in
+  REVERSING,  // Superstate of the outtake states
+  ROOT,       // Top of the hierarchy
+
+  HISTORY,   // Transition target only: the state ANTI_JAM interrupted
+  INTERNAL,  // Transition target only: run the action and stay, no exits, entries or timer reset
+};
+
+enum class IntakeEvent : uint8_t
+{
+  INTAKE_PRESSED,      // Intake button pressed
+  OUTTAKE_PRESSED,     // Outtake button pressed
+  RELEASED,            // Intake or outtake button released
+  SCORE_MODE_CHANGED,  // Score mode toggled
+  JAM,                 // Stages need reversing
+  TIMEOUT,             // Time in the state passed its timeout
+  BALL_ENTERED,        // Bottom detector started seeing a ball
+  BALL_CLEARED,        // Bottom detector stopped seeing a ball
+  COUNT
+};
+
+// Whether the jam detector watches a stage in a state
+enum class IntakeJamCheck : uint8_t
+{
+  ON,          // Watched
+  UNTIL_FULL,  // Watched until storage is full, then it is pushing against the balls
+  OFF,         // Not watched, the stage is meant to stall (holding balls back)
+};
+
+constexpr size_t kIntakeStateCount = static_cast<size_t>(IntakeState::ROOT) + 1;
+constexpr size_t kIntakeEventCount = static_cast<size_t>(IntakeEvent::COUNT);
+
+/**
+ * @brief What guards and actions can see and change
+ *
+ */
+struct IntakeContext
+{
+  bool score_mode = false;                    // Intake button scores instead of storing
+  bool intake_held = false;                   // Intake button is held
+  bool ball_detected = false;                 // Bottom detector sees a ball
+  bool storage_full = false;                  // A ball is held at the top of the middle stage
+  IntakeState resume = IntakeState::STOPPED;  // Where HISTORY goes
+  uint32_t jams = 0;                          // Times ANTI_JAM was entered
+};
+
+using IntakeGuard = bool (*)(const IntakeContext& context);
+using IntakeAction = void (*)(IntakeContext& context, IntakeState from);
+
+constexpr int16_t kIntakeKeep = INT16_MIN;  // Stage voltage that leaves the stage as it is
+
+struct IntakeStateInfo
+{
+  IntakeState parent = IntakeState::ROOT;  // Enclosing state (ROOT's parent is ROOT)
+
+  // Bottom, middle and top stage voltages (mV), kIntakeKeep leaves a stage as it is
+  std::array<int16_t, 3> voltage = {kIntakeKeep, kIntakeKeep, kIntakeKeep};
+
+  // Bottom, middle and top stage velocity targets (rpm), kIntakeKeep runs the voltage open loop
+  std::array<int16_t, 3> velocity = {kIntakeKeep, kIntakeKeep, kIntakeKeep};
+
+  // Bottom, middle and top stage jam checks, only used inside RUNNING
+  std::array<IntakeJamCheck, 3> jam_check = {
+      IntakeJamCheck::ON, IntakeJamCheck::ON, IntakeJamCheck::ON};
+
+  bool scaled = true;               // Voltages are scaled by the intake multipliers
+  bool brake = false;               // Coast the stages instead of driving them
+  uint32_t timeout = 0;             // Time before a TIMEOUT event (ms), 0 for none
+  IntakeAction on_entry = nullptr;  // Run when the state is entered
+  IntakeAction on_exit = nullptr;   // Run when the state is left
+};
+
+struct IntakeTransition
+{
+  IntakeState from;               // State (or superstate) the transition leaves
+  IntakeEvent event;              // Event that triggers it
+  IntakeGuard guard;              // Must return true for the transition to be taken, or nullptr
+  IntakeState to;                 // Leaf state to go to, HISTORY or INTERNAL
+  IntakeAction action = nullptr;  // Run between the exits and the entries
+};
+
+// One row per state, in IntakeState order
+inline constexpr std::array<IntakeStateInfo, kIntakeStateCount> kIntakeStates = []() {
+  using enum IntakeState;
+  return std::array<IntakeStateInfo, kIntakeStateCount>{{
+      /* STOPPED */ {.parent = ROOT, .voltage = {0, 0, 0}, .brake = true},
+      /* OUTTAKE */
+      {.parent = REVERSING,
+       .voltage = {-12000, -8000, -12000},
+       .velocity = {-180, -120, -180}},
+      /* OUTTAKEMIDDLE */
+      {.parent = REVERSING, .voltage = {12000, 12000, 3000}, .velocity = {180, 180, 45}},
+      // The top stage holds balls back against the middle, that's a force so it stays open loop.
+      // It stalls on purpose, and so does the middle stage once storage is full
+      /* STORING */
+      {.parent = RUNNING,
+       .voltage = {12000, 12000, -12000},
+       .velocity = {180, 180, kIntakeKeep},
+       .jam_check = {IntakeJamCheck::ON, IntakeJamCheck::UNTIL_FULL, IntakeJamCheck::OFF}},
+      /* SCORING */
+      {.parent = RUNNING, .voltage = {12000, 12000, 12000}, .velocity = {180, 180, 180}},
+      /* SCORE_MIDDLE */ {.parent = RUNNING},
+      /* STORE_TOP */
+      {.parent = RUNNING,
+       .voltage = {12000, 12000, -1500},
+       .velocity = {180, 180, kIntakeKeep},
+       .jam_check = {IntakeJamCheck::ON, IntakeJamCheck::UNTIL_FULL, IntakeJamCheck::OFF}},
+      // The intake runs its unjam sequence (JamSettings) and sends TIMEOUT when it is done
+      /* ANTI_JAM */
+      {.parent = ROOT,
+       .scaled = false,
+       .on_entry =
+           [](IntakeContext& context, IntakeState from) {
+             // Jamming again while reversing keeps the original state to go back to
+             if (from != ANTI_JAM) { context.resume = from; }
+             context.jams++;
+           }},
+      /* RUNNING */ {.parent = ROOT},
+      /* REVERSING */ {.parent = ROOT},
+      /* ROOT */ {.parent = ROOT},
+  }};
+}();
+
+// Checked from the current state up through its superstates, the first match (in order) wins
+inline constexpr std::array<IntakeTransition, 12> kIntakeTransitions = []() {
+  using enum IntakeState;
+  using enum IntakeEvent;
+
+  constexpr IntakeGuard score_mode = [](const IntakeContext& c) { return c.score_mode; };
+  constexpr IntakeGuard held_scoring = [](const IntakeContext& c) {
+    return c.intake_held && c.score_mode;
+  };
+  constexpr IntakeGuard held_storing = [](const IntakeContext& c) {
+    return c.intake_held && !c.score_mode;
+  };
+  constexpr IntakeGuard held = [](const IntakeContext& c) { return c.intake_held; };
+
+  // The unjam always finishes, the driver's buttons only change where it goes back to
+  constexpr IntakeAction resume_intake = [](IntakeContext& c, IntakeState) {
+    c.resume = c.score_mode ? SCORING : STORING;
+  };
+  constexpr IntakeAction resume_outtake = [](IntakeContext& c, IntakeState) {
+    c.resume = OUTTAKE;
+  };
+  constexpr IntakeAction resume_stopped = [](IntakeContext& c, IntakeState) {
+    c.resume = STOPPED;
+  };
+
+  return std::array<IntakeTransition, 12>{{
+      {ANTI_JAM, INTAKE_PRESSED, nullptr, INTERNAL, resume_intake},
+      {ANTI_JAM, OUTTAKE_PRESSED, nullptr, INTERNAL, resume_outtake},
+      {ANTI_JAM, RELEASED, nullptr, INTERNAL, resume_stopped},
+      {ANTI_JAM, SCORE_MODE_CHANGED, held, INTERNAL, resume_intake},
+      {ANTI_JAM, TIMEOUT, nullptr, HISTORY},
+      {ROOT, INTAKE_PRESSED, score_mode, SCORING},
+      {ROOT, INTAKE_PRESSED, nullptr, STORING},
+      {ROOT, OUTTAKE_PRESSED, nullptr, OUTTAKE},
+      {ROOT, RELEASED, nullptr, STOPPED},
+      {ROOT, JAM, nullptr, ANTI_JAM},
+      {RUNNING, SCORE_MODE_CHANGED, held_scoring, SCORING},
+      {RUNNING, SCORE_MODE_CHANGED, held_storing, STORING},
+  }};
+}();
+
+constexpr IntakeState intakeParent(IntakeState state)
+{
+  return kIntakeStates[static_cast<size_t>(state)].parent;
+}
+
+/**
+ * @brief Check if a state is inside another
+ *
+ * @param state Leaf state
+ * @param ancestor Superstate (or the state itself)
+ * @return true state is ancestor or one of its children
+ */
+constexpr bool intakeWithin(IntakeState state, IntakeState ancestor)
+{
+  for (; state != IntakeState::ROOT; state = intakeParent(state))
+  {
+    if (state == ancestor) { return true; }
+  }
+  return ancestor == IntakeState::ROOT;
+}
+
+/**
+ * @brief Transitions that can fire for each state and event, innermost state first
+ * @details Flattening the hierarchy at compile time keeps dispatch to a fixed number of guard
+ * checks, whatever the depth of the state.
+ *
+ */
+struct IntakeDispatchTable
+{
+  static constexpr size_t kCandidates = 4;  // Transitions per state and event
+  static constexpr uint8_t kNone = 0xFF;    // Empty candidate
+
+  using Candidates = std::array<uint8_t, kCandidates>;
+  std::array<std::array<Candidates, kIntakeEventCount>, kIntakeStateCount> candidates{};
+  bool overflow = false;  // A state and event has more than kCandidates transitions
+};
+
+constexpr IntakeDispatchTable makeIntakeDispatchTable()
+{
+  IntakeDispatchTable table;
+
+  for (size_t state = 0; state < kIntakeStateCount; state++)
+  {
+    for (size_t event = 0; event < kIntakeEventCount; event++)
+    {
+      auto& candidates = table.candidates[state][event];
+      candidates.fill(IntakeDispatchTable::kNone);
+      size_t count = 0;
+
+      IntakeState level = static_cast<IntakeState>(state);
+      while (true)
+      {
+        for (size_t i = 0; i < kIntakeTransitions.size(); i++)
+        {
+          const IntakeTransition& transition = kIntakeTransitions[i];
+          if (transition.from != level || static_cast<size_t>(transition.event) != event)
+          {
+            continue;
+          }
+
+          if (count == IntakeDispatchTable::kCandidates) { table.overflow = true; }
+          else { candidates[count++] = static_cast<uint8_t>(i); }
+        }
+
+        if (level == IntakeState::ROOT) { break; }
+        level = intakeParent(level);
+      }
+    }
+  }
+
+  return table;
+}
+
+inline constexpr IntakeDispatchTable kIntakeDispatch = makeIntakeDispatchTable();
+static_assert(!kIntakeDispatch.overflow, "Too many transitions for one state and event");
+
+/**
+ * @brief Runs the intake state tables, the owner turns the current state into motor commands
+ * @details Nothing here allocates or touches a device, so transitions can be checked on the host.
+ * Not thread safe, the owner guards it.
+ *
+ */
+class IntakeMachine
+{
+ private:
+  IntakeState state_ = IntakeState::STOPPED;  // Current leaf state
+  uint32_t entered_ = 0;                      // When the state was entered (ms)
+  IntakeContext context_;                     // Guard and action data
+
+ public:
+  /**
+   * @brief Handle an event
+   *
+   * @param event Event
+   * @param now Current time (ms)
+   * @return true A transition was taken
+   * @return false No transition for the event in this state
+   */
+  bool dispatch(IntakeEvent event, uint32_t now)
+  {
+    const auto& candidates =
+        kIntakeDispatch.candidates[static_cast<size_t>(state_)][static_cast<size_t>(event)];
+
+    for (uint8_t index : candidates)
+    {
+      if (index == IntakeDispatchTable::kNone) { break; }
+
+      const IntakeTransition& transition = kIntakeTransitions[index];
+      if (transition.guard != nullptr && !transition.guard(context_)) { continue; }
+
+      if (transition.to == IntakeState::INTERNAL)
+      {
+        if (transition.action != nullptr) { transition.action(context_, state_); }
+      }
+      else { this->transition(transition.to, transition.action, now); }
+      return true;
+    }
+
+    return false;
+  }
+
+  /**
+   * @brief Fire TIMEOUT once the state's timeout has passed
+   *
+   * @param now Current time (ms)
+   */
+  void update(uint32_t now)
+  {
+    uint32_t timeout = this->getInfo().timeout;
+    if (timeout != 0 && now - entered_ >= timeout) { this->dispatch(IntakeEvent::TIMEOUT, now); }
+  }
+
+  /**
+   * @brief Go straight to a state, running the exit and entry actions on the way
+   *
+   * @param target Leaf state (or HISTORY)
+   * @param now Current time (ms)
+   */
+  void force(IntakeState target, uint32_t now) { this->transition(target, nullptr, now); }
+
+  IntakeState getState() const { return state_; }
+
+  const IntakeStateInfo& getInfo() const { return kIntakeStates[static_cast<size_t>(state_)]; }
+
+  uint32_t getTimeInState(uint32_t now) const { return now - entered_; }
+
+  /**
+   * @brief Check if the jam detector should watch a stage right now
+   *
+   * @param stage Bottom (0), middle (1) or top (2)
+   * @return true The state pulls balls in and the stage isn't meant to stall in it
+   */
+  bool checksJams(size_t stage) const
+  {
+    if (!intakeWithin(state_, IntakeState::RUNNING)) { return false; }
+
+    switch (this->getInfo().jam_check[stage])
+    {
+      case IntakeJamCheck::ON: return true;
+      case IntakeJamCheck::UNTIL_FULL: return !context_.storage_full;
+      case IntakeJamCheck::OFF: return false;
+    }
+    return false;
+  }
+
+  IntakeContext& getContext() { return context_; }
+  const IntakeContext& getContext() const { return context_; }
+
+ private:
+  static size_t depth(IntakeState state)
+  {
+    size_t depth = 0;
+    for (; state != IntakeState::ROOT; state = intakeParent(state)) { depth++; }
+    return depth;
+  }
+
+  static const IntakeStateInfo& info(IntakeState state)
+  {
+    return kIntakeStates[static_cast<size_t>(state)];
+  }
+
+  /**
+   * @brief Exit up to the common ancestor, run the action, then enter down to the target
+   *
+   * @param target Leaf state (or HISTORY)
+   * @param action Transition action, may be nullptr
+   * @param now Current time (ms)
+   */
+  void transition(IntakeState target, IntakeAction action, uint32_t now)
+  {
+    if (target == IntakeState::HISTORY) { target = context_.resume; }
+
+    IntakeState from = state_;
+
+    // Common ancestor, a self transition exits and enters the state again
+    IntakeState a = from;
+    IntakeState b = target;
+    size_t depth_a = depth(a);
+    size_t depth_b = depth(b);
+    for (; depth_a > depth_b; depth_a--) { a = intakeParent(a); }
+    for (; depth_b > depth_a; depth_b--) { b = intakeParent(b); }
+    while (a != b)
+    {
+      a = intakeParent(a);
+      b = intakeParent(b);
+    }
+    IntakeState ancestor = a == from || a == target ? intakeParent(a) : a;
+
+    for (IntakeState state = from; state != ancestor; state = intakeParent(state))
+    {
+      if (info(state).on_exit != nullptr) { info(state).on_exit(context_, from); }
+    }
+
+    if (action != nullptr) { action(context_, from); }
+
+    // Entries run outermost first
+    std::array<IntakeState, kIntakeStateCount> path;
+    size_t length = 0;
+    for (IntakeState state = target; state != ancestor; state = intakeParent(state))
+    {
+      path[length++] = state;
+    }
+    while (length > 0)
+    {
+      IntakeState state = path[--length];
+      if (info(state).on_entry != nullptr) { info(state).on_entry(context_, from); }
+    }
+
+    state_ = target;
+    entered_ = now;
+  }
+};
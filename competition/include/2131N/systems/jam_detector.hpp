@@ -0,0 +1,133 @@
+/**
+ * @file jam_detector.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Stall detection for an intake stage over a short sliding window (no pros)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "2131N/systems/intake_machine.hpp"
+
+/**
+ * @brief One step of the unjam sequence
+ *
+ */
+struct UnjamStep
+{
+  std::array<int16_t, 3> voltage;  // Bottom, middle and top stage voltages (mV) or kIntakeKeep
+  uint32_t duration;               // How long to hold them (ms)
+};
+
+struct JamSettings
+{
+  static constexpr size_t kMaxSteps = 4;
+
+  float stall_velocity = 25.0f;   // A driven stage slower than this may be stalled (rpm)
+  float stall_current = 2000.0f;  // Current that means the stage is pushing on something (mA)
+  float stall_torque = 0.8f;      // Torque that means the stage is pushing on something (Nm)
+  int32_t min_voltage = 4000;     // Stages driven softer than this aren't checked (mV)
+  uint32_t spin_up = 150;         // Time after a new command before checking (ms)
+  size_t window = 4;              // Samples in the sliding window (at most 16)
+  size_t threshold = 3;           // Stalled samples in the window that make a jam
+
+  // Run in order when a jam is found, then the intake goes back to what it was doing
+  std::array<UnjamStep, kMaxSteps> unjam = {{{{-12000, -8000, kIntakeKeep}, 100}}};
+  size_t unjam_steps = 1;  // Steps in use
+};
+
+/**
+ * @brief Sensor readings for one stage
+ *
+ */
+struct StageSample
+{
+  int32_t target;   // What the stage was asked for (mV open loop, rpm closed loop)
+  int32_t voltage;  // Commanded voltage (mV)
+  float velocity;   // Actual velocity (rpm)
+  float current;    // Current draw (mA)
+  float torque;     // Output torque (Nm)
+};
+
+/**
+ * @brief Flags a stage as jammed once most of its recent samples look stalled
+ * @details A sample is stalled when the stage is being driven hard but barely turning while
+ * drawing a lot of current or torque. Samples are kept as bits of a shift register, so each
+ * update is a shift and a popcount. Spinning up looks like a stall too, so nothing is checked
+ * for a while after the target changes. A velocity loop moves the voltage every update, so the
+ * target is what starts a new window rather than the voltage.
+ *
+ */
+class JamDetector
+{
+ private:
+  const JamSettings* settings_;  // Thresholds
+  uint16_t history_ = 0;       // Stalled flags, newest in bit 0
+  int32_t last_target_ = 0;    // Target the window was started for
+  uint32_t command_time_ = 0;  // When the target last changed (ms)
+
+ public:
+  /**
+   * @brief Construct a new Jam Detector
+   *
+   * @param settings Thresholds (must outlive the detector)
+   */
+  explicit JamDetector(const JamSettings* settings) : settings_(settings) {}
+
+  /**
+   * @brief Add a sample
+   *
+   * @param sample Stage readings
+   * @param now Current time (ms)
+   * @return true The stage is jammed
+   * @return false It isn't (or can't be told yet)
+   */
+  bool update(const StageSample& sample, uint32_t now)
+  {
+    if (sample.target != last_target_)
+    {
+      last_target_ = sample.target;
+      command_time_ = now;
+      history_ = 0;
+    }
+
+    bool driven = std::abs(sample.voltage) >= settings_->min_voltage;
+    if (!driven || now - command_time_ < settings_->spin_up)
+    {
+      history_ = 0;
+      return false;
+    }
+
+    bool stalled = std::abs(sample.velocity) < settings_->stall_velocity &&
+                   (sample.current >= settings_->stall_current ||
+                    std::abs(sample.torque) >= settings_->stall_torque);
+
+    uint16_t mask = static_cast<uint16_t>((1u << std::min<size_t>(settings_->window, 16)) - 1);
+    history_ = static_cast<uint16_t>(((history_ << 1) | stalled) & mask);
+
+    return static_cast<size_t>(std::popcount(history_)) >= settings_->threshold;
+  }
+
+  /**
+   * @brief Forget the window, e.g. after unjamming
+   *
+   * @param now Current time (ms), checking starts again after the spin up time
+   */
+  void reset(uint32_t now)
+  {
+    history_ = 0;
+    command_time_ = now;
+  }
+};
@@ -0,0 +1,96 @@
+/**
+ * @file match_format.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief On-disk layout of match recordings (shared with the host decoder)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Recordings are a sequence of 512 byte blocks (one SD sector each), only ever appended to.
+// Block 0 is a HEADER block, then DATA blocks with an INDEX block after every
+// kMatchIndexInterval data blocks (and at the end) listing when each of them started.
+
+constexpr uint32_t kMatchBlockSize = 512;
+constexpr uint32_t kMatchMagic = 0x4345524D;  // "MREC"
+constexpr uint8_t kMatchVersion = 1;
+
+constexpr size_t kMatchMaxMotors = 12;    // Motor slots in a frame
+constexpr size_t kMatchMaxDistances = 4;  // Distance sensor slots in a frame
+
+enum class MatchBlockType : uint8_t
+{
+  HEADER,  // MatchFileInfo
+  DATA,    // MatchFrame[count]
+  INDEX,   // MatchIndexEntry[count]
+};
+
+struct MatchBlockHeader
+{
+  uint32_t magic;      // kMatchMagic
+  uint8_t type;        // MatchBlockType
+  uint8_t version;     // kMatchVersion
+  uint16_t count;      // Frames or index entries in the block
+  uint32_t sequence;   // Block number in the file
+  uint32_t timestamp;  // Time of the first frame, or when the block was written (ms)
+};
+
+struct MatchFileInfo
+{
+  uint16_t frame_size;        // sizeof(MatchFrame)
+  uint16_t frames_per_block;  // kMatchFramesPerBlock
+  uint16_t motor_count;       // Motor slots in use
+  uint16_t distance_count;    // Distance slots in use
+  uint32_t period;            // Time between frames (ms)
+  uint32_t start_time;        // Time recording started (ms)
+};
+
+struct MatchFrame
+{
+  uint32_t timestamp;  // Time of the sample (ms)
+
+  float x;                 // Odometry x (in)
+  float y;                 // Odometry y (in)
+  float theta;             // Odometry heading (deg)
+  float velocity;          // Forwards velocity (in/s)
+  float angular_velocity;  // Turn rate (deg/s)
+
+  float mcl_x;         // MCL estimate x (in)
+  float mcl_y;         // MCL estimate y (in)
+  float mcl_variance;  // MCL particle variance (in^2)
+
+  uint16_t distance[kMatchMaxDistances];  // Distance sensor readings (0.01 in)
+  int16_t voltage[kMatchMaxMotors];       // Motor voltages (mV)
+  int16_t current[kMatchMaxMotors];       // Motor current draw (mA)
+  uint8_t temperature[kMatchMaxMotors];   // Motor temperatures (C)
+
+  uint16_t battery_voltage;  // Battery voltage (mV)
+  uint8_t intake_state;      // Intake::states
+  uint8_t flags;             // kMatchFlag bits
+  uint8_t reserved[16];      // Pads four frames to exactly fill a block
+};
+
+constexpr uint8_t kMatchFlagBallDetected = 1 << 0;  // Intake detector sees a ball
+
+struct MatchIndexEntry
+{
+  uint32_t sequence;   // Block number of a data block
+  uint32_t timestamp;  // Time of its first frame (ms)
+};
+
+constexpr size_t kMatchFramesPerBlock =
+    (kMatchBlockSize - sizeof(MatchBlockHeader)) / sizeof(MatchFrame);
+constexpr size_t kMatchIndexInterval =
+    (kMatchBlockSize - sizeof(MatchBlockHeader)) / sizeof(MatchIndexEntry);
+
+static_assert(sizeof(MatchBlockHeader) == 16);
+static_assert(
+    sizeof(MatchBlockHeader) + kMatchFramesPerBlock * sizeof(MatchFrame) == kMatchBlockSize,
+    "Frames should exactly fill a block");
@@ -0,0 +1,158 @@
+/**
+ * @file match_recorder.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Records robot state to the SD card for post-match analysis
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "2131N/systems/chassis.hpp"
+#include "2131N/systems/intake.hpp"
+#include "2131N/systems/match_format.hpp"
+#include "2131N/systems/mcl/time_of_flight.hpp"
+#include "pros/abstract_motor.hpp"
+#include "pros/rtos.hpp"
+
+struct MclSample
+{
+  float x;         // Estimated x position (in)
+  float y;         // Estimated y position (in)
+  float variance;  // Particle variance around the estimate (in^2)
+};
+
+class MatchRecorder
+{
+ public:
+  static constexpr size_t kBlocksPerBuffer = 8;  // 4KB per write to the card
+
+ private:
+  struct Buffer
+  {
+    std::array<uint8_t, kBlocksPerBuffer * kMatchBlockSize> data;  // Whole blocks
+    size_t blocks = 0;                                             // Blocks filled
+    uint32_t order = 0;                // Hand-off order, so the writer keeps them in sequence
+    std::atomic<bool> pending{false};  // Handed to the writer, not yet on the card
+  };
+
+  Chassis* chassis_;                               // Odometry and speeds
+  Intake* intake_;                                 // Intake state and ball detector
+  std::vector<DistanceSensor*> distance_sensors_;  // Distance readings
+  std::vector<pros::AbstractMotor*> motors_;       // Motors to record, in frame slot order
+  std::function<MclSample()> mcl_sample_;          // MCL estimate source
+
+  std::array<Buffer, 2> buffers_;  // Double buffer, one filling while the other is written
+  size_t active_ = 0;              // Buffer being filled
+  uint32_t handoffs_ = 0;          // Buffers handed to the writer
+  uint32_t sequence_ = 0;          // Next block number
+
+  uint8_t* open_block_ = nullptr;  // Data block being filled
+  uint16_t frame_count_ = 0;       // Frames in the open data block
+  uint32_t block_timestamp_ = 0;   // Time of the open block's first frame (ms)
+
+  std::array<MatchIndexEntry, kMatchIndexInterval> index_;  // Data blocks since the last index
+  size_t index_count_ = 0;                                  // Entries in use
+
+  FILE* file_ = nullptr;                // Open recording
+  std::atomic<bool> recording_{false};  // Is the sampler adding frames
+  std::atomic<bool> closing_{false};    // Close the file once every buffer is written
+  std::atomic<uint32_t> dropped_{0};    // Frames lost because both buffers were full
+  pros::Mutex mutex_;                   // Guards the blocks and the file between the threads
+
+  uint32_t period_;         // Sample period (ms)
+  pros::Task sample_task_;  // Thread that fills the buffers
+  pros::Task writer_task_;  // Low priority thread that writes full buffers to the card
+
+ public:
+  /**
+   * @brief Construct a new Match Recorder
+   *
+   * @param chassis Chassis to record
+   * @param intake Intake to record
+   * @param distance_sensors Distance sensors to record (up to 4)
+   * @param motors Motors and motor groups to record (up to 12 motors in total)
+   * @param mcl_sample Returns the latest MCL estimate
+   * @param period Sample period (ms)
+   */
+  MatchRecorder(
+      Chassis* chassis,
+      Intake* intake,
+      std::vector<DistanceSensor*> distance_sensors,
+      std::vector<pros::AbstractMotor*> motors,
+      std::function<MclSample()> mcl_sample,
+      uint32_t period = 20);
+
+  /**
+   * @brief Start a new recording in the next free /usd/match_NNN.bin
+   *
+   * @return true Recording (or already recording)
+   * @return false No SD card or the file couldn't be created
+   */
+  bool start();
+
+  /**
+   * @brief Finish the recording, the file is closed once the writer catches up
+   *
+   */
+  void stop();
+
+  bool isRecording() const { return recording_.load(); }
+
+  uint32_t getDropped() const { return dropped_.load(); }
+
+ private:
+  /**
+   * @brief Get the next free block in the active buffer, handing full buffers to the writer
+   *
+   * @return uint8_t* Block, nullptr if both buffers are waiting to be written
+   */
+  uint8_t* nextBlock();
+
+  /**
+   * @brief Hand the active buffer to the writer and switch to the other one
+   *
+   */
+  void handOff();
+
+  /**
+   * @brief Finish the open data block and note it in the index
+   *
+   */
+  void closeDataBlock();
+
+  /**
+   * @brief Write an index block for the data blocks since the last one
+   *
+   */
+  void writeIndex();
+
+  /**
+   * @brief Sample every source into a frame
+   *
+   * @param frame Frame to fill
+   */
+  void sample(MatchFrame& frame);
+
+  /**
+   * @brief Add one frame to the recording (sampler thread)
+   *
+   */
+  void update();
+
+  /**
+   * @brief Write pending buffers to the card (writer thread)
+   *
+   */
+  void write();
+};
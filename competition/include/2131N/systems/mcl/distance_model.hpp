@@ -0,0 +1,95 @@
+/**
+ * @file distance_model.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Geometry and reading of a distance sensor, without the hardware
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+#include "point.hpp"
+
+class DistanceModel
+{
+ protected:
+  // Offsets relative to robot center
+  Point offset;
+  double heading_offset;  // in radians
+
+  // Cache last pose to avoid redundant calculations
+  double last_heading;
+  Point last_position;
+
+  // Cache trig functions for efficiency
+  double cached_sin;
+  double cached_cos;
+
+  // Cached distance reading (inches, -1 if there is no usable reading)
+  double last_distance_reading;
+
+  // Distance Sensor noise
+  const double distance_sensor_std = 25.0 / 25.4;  // 25 mm in inches
+
+ public:
+  DistanceModel(Point offset, double heading_offset)
+      : offset(offset),
+        heading_offset(heading_offset),
+        last_heading(std::numeric_limits<double>::infinity()),
+        last_position(
+            {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()}),
+        cached_sin(0.0),
+        cached_cos(1.0),
+        last_distance_reading(0.0000001)
+  {
+  }
+
+  /**
+   * @brief Move the sensor with the robot
+   *
+   * @param robot_position Robot position (in)
+   * @param robot_heading Robot heading (rad)
+   * @return true The pose changed, so the reading should be refreshed
+   * @return false Same pose as last time
+   */
+  bool update_pose(const Point& robot_position, const double& robot_heading)
+  {
+    bool heading_changed = (robot_heading != last_heading);
+    bool position_changed = (robot_position != last_position);
+
+    if (heading_changed)
+    {
+      last_heading = robot_heading;
+      // Update trig values, assuming theta = 0 is on y+
+      cached_sin = std::sin(M_PI_2 - (robot_heading + heading_offset));
+      cached_cos = std::cos(M_PI_2 - (robot_heading + heading_offset));
+    }
+
+    // If Position changed, update the last position
+    if (position_changed) { last_position = robot_position; }
+
+    return heading_changed || position_changed;
+  }
+
+  void set_distance_reading(double reading) { last_distance_reading = reading; }
+
+  double get_cosine_cache() const { return cached_cos; }
+  double get_sine_cache() const { return cached_sin; }
+  Point get_offset() const { return offset; }
+  double get_heading_offset() const { return heading_offset; }
+  Point get_sensor_position(Point robot_position, double robot_heading) const
+  {
+    return {
+        robot_position.x + offset.x * std::sin(robot_heading) - offset.y * std::cos(robot_heading),
+        robot_position.y + offset.x * std::cos(robot_heading) + offset.y * std::sin(robot_heading)};
+  }
+
+  double get_distance_reading() const { return last_distance_reading; }
+  double get_distance_sensor_std() const { return distance_sensor_std; }
+};
@@ -0,0 +1,35 @@
+/**
+ * @file sensor_mounts.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Where the distance sensors sit on the robot, shared by the robot and the host tools
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+
+#include "point.hpp"
+
+struct SensorMount
+{
+  Point offset;    // From the robot center (in)
+  double heading;  // From the robot heading (rad)
+};
+
+inline constexpr SensorMount kLeftDistanceMount{{-1.5, 6.25}, -M_PI_2};
+inline constexpr SensorMount kBackDistanceMount{{4.75, -2.25}, M_PI};
+inline constexpr SensorMount kRightDistanceMount{{-2.75, -6}, M_PI_2};
+inline constexpr SensorMount kFrontDistanceMount{{-6, -4.5}, 0};
+
+// In the order MCL reads them and the match recorder writes them
+inline constexpr std::array<SensorMount, 4> kDistanceMounts = {
+    kLeftDistanceMount,
+    kBackDistanceMount,
+    kRightDistanceMount,
+    kFrontDistanceMount};
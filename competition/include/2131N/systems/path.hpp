@@ -0,0 +1,134 @@
+/**
+ * @file path.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Spatially indexed path for the pure pursuit follower
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "lemlib/asset.hpp"
+#include "lemlib/pose.hpp"
+
+struct PathSettings
+{
+  float max_speed;                 // Fastest the chassis can drive (in/s), 127 in the file
+  float max_lateral_acceleration;  // Cornering limit used for the curvature speed cap (in/s^2)
+  float max_deceleration;          // Braking limit used to slow down ahead of corners (in/s^2)
+  float min_speed = 5.0f;          // Slowest speed the follower will command, up to the end (in/s)
+  float cell_size = 6.0f;          // Side length of a lookup grid cell (in)
+  float search_distance = 24.0f;   // How far along the path a query may jump ahead (in)
+};
+
+struct PathPoint
+{
+  float x;          // X position (in)
+  float y;          // Y position (in)
+  float speed;      // Speed limit (in/s), after the curvature and braking caps
+  float distance;   // Distance along the path from the start (in)
+  float curvature;  // Unsigned curvature at this point (1/in)
+};
+
+class Path
+{
+ private:
+  PathSettings settings_;          // Limits used when the path was built
+  std::vector<PathPoint> points_;  // Points along the path
+
+  // Segment lookup grid. Cell c holds segments cell_segments_[cell_start_[c]..cell_start_[c + 1]]
+  float grid_min_x_ = 0.0f;              // X of the grid origin (in)
+  float grid_min_y_ = 0.0f;              // Y of the grid origin (in)
+  size_t grid_columns_ = 0;              // Cells across
+  size_t grid_rows_ = 0;                 // Cells down
+  std::vector<uint32_t> cell_start_;     // Offset of each cell's segments
+  std::vector<uint32_t> cell_segments_;  // Segment indices, sorted within each cell
+
+ public:
+  /**
+   * @brief Construct a Path from a path.jerryio / LemLib asset ("x, y, speed" lines)
+   *
+   * @param file Path asset
+   * @param settings Speed limits and grid settings
+   */
+  Path(const asset& file, PathSettings settings);
+
+  /**
+   * @brief Construct a Path from a list of points
+   *
+   * @param points Points, with the speed in file units (0-127) as theta
+   * @param settings Speed limits and grid settings
+   */
+  Path(const std::vector<lemlib::Pose>& points, PathSettings settings);
+
+  /**
+   * @brief Find the closest point on the path, searching forwards from a cursor
+   *
+   * @param pose Robot pose
+   * @param cursor Segment the last query ended on, only moves forwards
+   * @return lemlib::Pose Closest point on the path (theta holds the segment fraction)
+   */
+  lemlib::Pose closestPoint(const lemlib::Pose& pose, size_t& cursor) const;
+
+  /**
+   * @brief Find the furthest path intersection with a circle around the robot
+   *
+   * @param pose Robot pose
+   * @param radius Lookahead distance (in)
+   * @param cursor Segment of the closest point, the search starts here
+   * @return lemlib::Pose Lookahead point (the last point when past the end)
+   */
+  lemlib::Pose lookaheadPoint(const lemlib::Pose& pose, float radius, size_t cursor) const;
+
+  /**
+   * @brief Interpolated speed limit along a segment
+   *
+   * @param segment Segment index
+   * @param fraction How far along the segment (0-1)
+   * @return float Speed limit (in/s)
+   */
+  float speedAt(size_t segment, float fraction) const;
+
+  /**
+   * @brief Interpolated distance from the start along a segment
+   *
+   * @param segment Segment index
+   * @param fraction How far along the segment (0-1)
+   * @return float Distance (in)
+   */
+  float distanceAt(size_t segment, float fraction) const;
+
+  const std::vector<PathPoint>& getPoints() const { return points_; }
+  size_t getSegmentCount() const { return points_.size() < 2 ? 0 : points_.size() - 1; }
+  float getLength() const { return points_.empty() ? 0.0f : points_.back().distance; }
+
+ private:
+  /**
+   * @brief Compute distances, curvature and the speed profile
+   *
+   */
+  void buildProfile();
+
+  /**
+   * @brief Bucket every segment into the lookup grid
+   *
+   */
+  void buildGrid();
+
+  /**
+   * @brief Get the grid cell a position falls in (clamped to the grid)
+   *
+   * @param x X position (in)
+   * @param y Y position (in)
+   * @param column Cell column
+   * @param row Cell row
+   */
+  void cellOf(float x, float y, size_t& column, size_t& row) const;
+};
@@ -0,0 +1,82 @@
+/**
+ * @file pose_predictor.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Forecasts the chassis pose from its velocity and commanded acceleration
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include "lemlib/pose.hpp"
+
+struct PredictorSettings
+{
+  float max_speed;              // Wheel speed at 12V (in/s)
+  float track_width;            // Distance between the drive sides (in)
+  float time_constant;          // Time for a drive side to reach ~63% of a new speed (s)
+  float max_deceleration;       // Braking deceleration used to find where the robot stops (in/s^2)
+  float end_tolerance;          // Predicted stop this close to a target counts as arriving (in)
+  float end_angular_tolerance;  // Predicted stop this close to a heading counts as arriving (deg)
+};
+
+class PosePredictor
+{
+ private:
+  PredictorSettings settings_;  // Drivetrain model
+
+  lemlib::Pose pose_{0.0f, 0.0f, 0.0f};  // Last pose (radians)
+  float left_velocity_ = 0.0f;           // Left side speed (in/s)
+  float right_velocity_ = 0.0f;          // Right side speed (in/s)
+  float left_command_ = 0.0f;            // Speed the left side is being driven towards (in/s)
+  float right_command_ = 0.0f;           // Speed the right side is being driven towards (in/s)
+
+ public:
+  /**
+   * @brief Construct a new Pose Predictor
+   *
+   * @param settings Drivetrain model
+   */
+  PosePredictor(PredictorSettings settings);
+
+  /**
+   * @brief Update the predictor with the latest state of the chassis
+   *
+   * @param pose Current pose (radians)
+   * @param velocity Forward speed (in/s)
+   * @param angular_velocity Clockwise turn rate (rad/s)
+   * @param left_voltage Voltage commanded to the left side (mV)
+   * @param right_voltage Voltage commanded to the right side (mV)
+   */
+  void update(
+      const lemlib::Pose& pose,
+      float velocity,
+      float angular_velocity,
+      float left_voltage,
+      float right_voltage);
+
+  /**
+   * @brief Predict the pose if the current commands are held
+   *
+   * @param time Time ahead to predict (ms)
+   * @return lemlib::Pose Predicted pose (degrees)
+   */
+  lemlib::Pose predict(float time) const;
+
+  /**
+   * @brief Predict where the chassis comes to rest if it brakes now
+   *
+   * @return lemlib::Pose Predicted resting pose (degrees)
+   */
+  lemlib::Pose predictStop() const;
+
+  /**
+   * @brief Get the drivetrain model
+   *
+   * @return const PredictorSettings& Settings
+   */
+  const PredictorSettings& getSettings() const;
+};
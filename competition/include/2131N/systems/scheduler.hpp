@@ -0,0 +1,127 @@
+/**
+ * @file scheduler.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Periodic jobs with rate-monotonic priorities, overrun and CPU reporting
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+#include "pros/rtos.hpp"
+
+/**
+ * @brief How a job has been running, over the last second for the utilization
+ *
+ */
+struct JobStats
+{
+  const char* name = "";     // Job name
+  uint32_t period = 0;       // Release period (ms)
+  uint32_t deadline = 0;     // Time a run has to finish in after its release (ms)
+  uint32_t priority = 0;     // Task priority it was given
+  uint32_t runs = 0;         // Times the job has run
+  uint32_t overruns = 0;     // Runs that finished after their deadline
+  uint32_t max_runtime = 0;  // Longest run (us)
+  float utilization = 0.0f;  // Share of the CPU the job used (0-1)
+};
+
+/**
+ * @brief Runs periodic jobs, each in its own task, released on a fixed schedule
+ * @details Jobs are released with delay_until so their timing doesn't drift with how long a run
+ * takes. Priorities are handed out rate-monotonically when the scheduler starts: the shorter the
+ * period the higher the priority, from TASK_PRIORITY_DEFAULT down (so the drive velocity loop
+ * and the trigger engine stay above every job). A run that misses its deadline is counted, and
+ * if it also misses the next release the schedule restarts from now instead of running the job
+ * back to back to catch up.
+ *
+ */
+class Scheduler
+{
+ public:
+  static constexpr size_t kMaxJobs = 8;                                // Jobs that can be added
+  static constexpr uint32_t kHighestPriority = TASK_PRIORITY_DEFAULT;  // Fastest job's priority
+  static constexpr uint32_t kLowestPriority = TASK_PRIORITY_MIN + 2;   // Above the logging tasks
+  static constexpr uint32_t kWindow = 1000000;                         // Utilization window (us)
+
+ private:
+  struct Job
+  {
+    const char* name = "";           // Task name
+    uint32_t period = 0;             // Release period (ms)
+    uint32_t deadline = 0;           // Deadline after each release (ms)
+    uint32_t priority = 0;           // Given in start()
+    std::function<void()> step;      // One run of the job
+    std::optional<pros::Task> task;  // Thread the job runs in
+
+    std::atomic<uint32_t> runs{0};         // Times run
+    std::atomic<uint32_t> overruns{0};     // Deadlines missed
+    std::atomic<uint32_t> max_runtime{0};  // Longest run (us)
+    std::atomic<float> utilization{0.0f};  // CPU share over the last window
+  };
+
+  std::array<Job, kMaxJobs> jobs_;  // Jobs in the order they were added
+  size_t job_count_ = 0;            // Jobs added
+  bool started_ = false;            // Jobs can't be added once they are running
+
+ public:
+  /**
+   * @brief Add a periodic job, must be called before start()
+   *
+   * @param name Job name (must outlive the scheduler, e.g. a string literal)
+   * @param period Release period (ms)
+   * @param deadline Time each run has to finish in (ms), 0 for the period
+   * @param step One run of the job, should return well within the deadline
+   * @return true The job was added
+   * @return false The scheduler is full or already started
+   */
+  bool addJob(const char* name, uint32_t period, uint32_t deadline, std::function<void()> step);
+
+  /**
+   * @brief Give every job its priority and start running them
+   *
+   */
+  void start();
+
+  /**
+   * @brief Get how a job has been running
+   *
+   * @param index Job index, in the order they were added
+   * @return JobStats Job stats
+   */
+  JobStats getStats(size_t index) const;
+
+  /**
+   * @brief Get the share of the CPU all the jobs used over the last second
+   *
+   * @return float Utilization (0-1)
+   */
+  float getUtilization() const;
+
+  /**
+   * @brief Get the deadlines missed by all the jobs
+   *
+   * @return uint32_t Overruns
+   */
+  uint32_t getOverruns() const;
+
+  size_t size() const { return job_count_; }
+
+ private:
+  /**
+   * @brief Release the job on its schedule forever (job's task)
+   *
+   * @param job Job to run
+   */
+  static void run(Job& job);
+};
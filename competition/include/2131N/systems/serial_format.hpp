@@ -0,0 +1,174 @@
+/**
+ * @file serial_format.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Wire format of the live serial telemetry stream (shared with the host receiver)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "2131N/utils/cobs.hpp"
+#include "2131N/utils/varint.hpp"
+
+// Every packet is COBS encoded with a zero byte before and after it, so the host can drop a
+// damaged packet (or stray printf output) and pick up again at the next zero.
+//
+// Packet:  type | sequence | fields as varints | fletcher-16 (2 bytes, little endian)
+//
+// Pose fields are quantized and sent as the difference from the last pose, every
+// kSerialKeyInterval'th pose (flagged kSerialKeyFrame) is sent from zero so a receiver that
+// missed a packet can resync. Particle packets are always complete, the particles are sorted by
+// x so each one is a small step from the one before.
+
+constexpr size_t kSerialMaxPacket = 1024;    // Largest unencoded packet
+constexpr uint32_t kSerialKeyInterval = 50;  // Poses between key frames
+constexpr uint8_t kSerialKeyFrame = 0x80;    // Type flag, fields are absolute
+
+constexpr double kSerialPositionScale = 100.0;   // Counts per inch
+constexpr double kSerialHeadingScale = 100.0;    // Counts per degree
+constexpr double kSerialVelocityScale = 100.0;   // Counts per in/s
+constexpr double kSerialAngularScale = 1000.0;   // Counts per rad/s
+constexpr double kSerialParticleScale = 10.0;    // Counts per inch
+constexpr double kSerialVarianceScale = 1000.0;  // Counts per in^2
+
+enum class SerialPacketType : uint8_t
+{
+  POSE,       // SerialPose
+  PARTICLES,  // Estimate, variance, then a decimated particle cloud
+};
+
+/**
+ * @brief Pose as it travels, in quantized counts
+ *
+ */
+struct SerialPose
+{
+  int32_t timestamp;         // ms
+  int32_t x;                 // kSerialPositionScale
+  int32_t y;                 // kSerialPositionScale
+  int32_t theta;             // kSerialHeadingScale
+  int32_t velocity;          // kSerialVelocityScale
+  int32_t angular_velocity;  // kSerialAngularScale
+};
+
+constexpr size_t kSerialPoseFields = sizeof(SerialPose) / sizeof(int32_t);
+
+/**
+ * @brief Quantize a value for the wire
+ *
+ * @param value Value
+ * @param scale Counts per unit
+ * @return int32_t Counts
+ */
+inline int32_t serialQuantize(double value, double scale)
+{
+  if (!std::isfinite(value)) { return 0; }
+  return static_cast<int32_t>(std::lround(value * scale));
+}
+
+/**
+ * @brief Fletcher-16 checksum
+ *
+ * @param data Bytes
+ * @param length Number of bytes
+ * @return uint16_t Checksum
+ */
+inline uint16_t serialChecksum(const uint8_t* data, size_t length)
+{
+  uint16_t a = 0;
+  uint16_t b = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    a = (a + data[i]) % 255;
+    b = (b + a) % 255;
+  }
+  return static_cast<uint16_t>(b << 8 | a);
+}
+
+/**
+ * @brief Write the pose fields, relative to the last pose unless it's a key frame
+ *
+ * @param out Output, advanced past the fields
+ * @param pose Pose to send
+ * @param last Last pose sent (ignored on a key frame)
+ * @param key Send absolute values
+ */
+inline void serialPutPose(uint8_t*& out, const SerialPose& pose, const SerialPose& last, bool key)
+{
+  const int32_t* fields = &pose.timestamp;
+  const int32_t* last_fields = &last.timestamp;
+  for (size_t i = 0; i < kSerialPoseFields; i++)
+  {
+    putSignedVarint(out, key ? fields[i] : fields[i] - last_fields[i]);
+  }
+}
+
+/**
+ * @brief Read the pose fields
+ *
+ * @param in Input, advanced past the fields
+ * @param end End of the input
+ * @param pose Updated with the pose (holds the last pose on the way in unless it's a key frame)
+ * @param key The fields are absolute
+ * @return true Read every field
+ * @return false Packet too short
+ */
+inline bool serialGetPose(const uint8_t*& in, const uint8_t* end, SerialPose& pose, bool key)
+{
+  SerialPose next = pose;
+  int32_t* fields = &next.timestamp;
+  for (size_t i = 0; i < kSerialPoseFields; i++)
+  {
+    int32_t value;
+    if (!getSignedVarint(in, end, value)) { return false; }
+    fields[i] = key ? value : fields[i] + value;
+  }
+  pose = next;
+  return true;
+}
+
+/**
+ * @brief Checksum and COBS encode a packet into a frame with its delimiters
+ *
+ * @param packet Packet
+ * @param length Packet length (without the checksum)
+ * @param frame Output, cobsMaxEncodedSize(length + 2) + 2 bytes of space
+ * @return size_t Frame length
+ */
+inline size_t serialFrame(uint8_t* packet, size_t length, uint8_t* frame)
+{
+  uint16_t checksum = serialChecksum(packet, length);
+  packet[length++] = checksum & 0xFF;
+  packet[length++] = checksum >> 8;
+
+  frame[0] = 0;
+  size_t size = 1 + cobsEncode(packet, length, frame + 1);
+  frame[size++] = 0;
+  return size;
+}
+
+/**
+ * @brief Decode a frame (between delimiters) and check its checksum
+ *
+ * @param frame Encoded bytes
+ * @param length Encoded length
+ * @param packet Output, length bytes of space
+ * @return size_t Packet length without the checksum, 0 if it's damaged
+ */
+inline size_t serialUnframe(const uint8_t* frame, size_t length, uint8_t* packet)
+{
+  size_t size = cobsDecode(frame, length, packet);
+  if (size < 4) { return 0; }
+
+  size -= 2;
+  uint16_t checksum = packet[size] | packet[size + 1] << 8;
+  return checksum == serialChecksum(packet, size) ? size : 0;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file serial_telemetry.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Live pose and particle stream over the USB serial port for a host dashboard
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "2131N/systems/chassis.hpp"
+#include "2131N/systems/mcl/point.hpp"
+#include "2131N/systems/serial_format.hpp"
+#include "pros/rtos.hpp"
+
+/**
+ * @brief Decimated particle filter state to send to the dashboard
+ *
+ */
+struct SerialParticleCloud
+{
+  static constexpr size_t kMaxParticles = 64;
+
+  Point estimate;                                // Filter estimate (in)
+  double variance = 0.0;                         // Particle variance around the estimate (in^2)
+  size_t count = 0;                              // Particles in use
+  std::array<Point, kMaxParticles> particles{};  // Particle positions (in)
+};
+
+// Type, sequence, timestamp, estimate, variance, count, particles and the checksum, all at their
+// longest
+static_assert(
+    2 + 5 * kVarintMaxSize + 2 * SerialParticleCloud::kMaxParticles * kVarintMaxSize + 2 <=
+        kSerialMaxPacket,
+    "A full particle cloud must fit in a packet");
+
+class SerialTelemetry
+{
+ private:
+  Chassis* chassis_;                                     // Pose source
+  std::function<void(SerialParticleCloud&)> particles_;  // Fills the particle cloud
+
+  uint32_t period_;              // Pose period (ms)
+  uint32_t particle_period_;     // Particle cloud period (ms)
+  uint32_t last_particles_ = 0;  // Time the last cloud was sent (ms)
+
+  SerialPose last_pose_{};         // Last pose sent, deltas are taken from it
+  uint32_t poses_sent_ = 0;        // Counts towards the next key frame
+  uint8_t pose_sequence_ = 0;      // Pose packet count, gaps mean lost frames
+  uint8_t particle_sequence_ = 0;  // Particle packet count
+
+  SerialParticleCloud cloud_;                                            // Scratch cloud
+  std::array<uint8_t, kSerialMaxPacket> packet_;                         // Scratch packet
+  std::array<uint8_t, cobsMaxEncodedSize(kSerialMaxPacket) + 2> frame_;  // Scratch frame
+
+  std::atomic<bool> running_{false};  // Is the stream on
+  std::atomic<uint32_t> dropped_{0};  // Frames the serial driver had no room for
+  pros::Task task_;                   // Low priority thread that samples and sends
+
+ public:
+  /**
+   * @brief Construct a new Serial Telemetry stream
+   *
+   * @param chassis Chassis to send the pose of
+   * @param particles Fills in the particle cloud, can be empty
+   * @param period Pose period (ms)
+   * @param particle_period Particle cloud period (ms)
+   */
+  SerialTelemetry(
+      Chassis* chassis,
+      std::function<void(SerialParticleCloud&)> particles,
+      uint32_t period = 10,
+      uint32_t particle_period = 200);
+
+  /**
+   * @brief Take over stdout for the stream
+   * @details Turns off the PROS stream multiplexing so the frames go out as they are, which
+   * means `pros terminal` can't show prints while the stream is on. Writes stop blocking, a
+   * full serial buffer drops frames instead of stalling anything.
+   *
+   */
+  void start();
+
+  /**
+   * @brief Give stdout back to the PROS terminal
+   *
+   */
+  void stop();
+
+  bool isRunning() const { return running_.load(); }
+
+  uint32_t getDropped() const { return dropped_.load(); }
+
+ private:
+  /**
+   * @brief Frame and write a packet
+   *
+   * @param length Packet length in packet_
+   */
+  void send(size_t length);
+
+  void sendPose();
+
+  void sendParticles();
+
+  /**
+   * @brief Background thread impl
+   *
+   */
+  void update();
+};
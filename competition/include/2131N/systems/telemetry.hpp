@@ -0,0 +1,233 @@
+/**
+ * @file telemetry.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Binary telemetry logging that is cheap enough for control loops
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include "2131N/systems/telemetry_format.hpp"
+#include "2131N/utils/deferred_format.hpp"
+#include "2131N/utils/mpsc_ring.hpp"
+#include "2131N/utils/spsc_ring.hpp"
+#include "lemlib/logger/message.hpp"
+#include "pros/rtos.hpp"
+
+namespace lemlib
+{
+class BaseSink;
+}
+
+enum class TelemetrySink
+{
+  NONE,    // Records are drained and discarded
+  SERIAL,  // USB serial (stdout)
+  SD,      // File on the microSD card
+};
+
+class Telemetry
+{
+ public:
+  static constexpr size_t kChannelCount = static_cast<size_t>(TelemetryChannel::COUNT);
+  static constexpr size_t kRingSize = 64;   // Records per channel, 640ms at 100Hz
+  static constexpr size_t kBatchSize = 32;  // Records per write to the sink
+
+ private:
+  std::array<SpscRing<TelemetryRecord, kRingSize>, kChannelCount> rings_;  // One ring per channel
+  std::array<uint16_t, kChannelCount> sequences_{};  // Next sequence, owned by the producers
+  std::atomic<bool> enabled_{false};                 // Are records being kept
+
+  MpscRing<TelemetryRecord, kRingSize> messages_;   // Deferred log messages from every task
+  std::atomic<uint16_t> message_sequence_{0};       // Next message sequence
+  std::array<bool, DeferredFormatRegistry::kMaxFormats> formats_sent_{};  // Definitions written
+  std::shared_ptr<lemlib::BaseSink> message_sink_;  // Gets formatted messages from the drain
+
+  std::array<TelemetryRecord, kBatchSize> batch_;  // Records waiting to be written (drain only)
+  size_t batch_count_ = 0;                         // Records in the batch
+
+  TelemetrySink sink_ = TelemetrySink::NONE;  // Where records are written
+  FILE* file_ = nullptr;                      // Open sink stream
+  pros::Mutex sink_mutex_;                    // Guards the sink between open/close and the drain
+
+  uint32_t period_;        // Drain period (ms)
+  pros::Task drain_task_;  // Low priority thread that empties the rings into the sink
+
+ public:
+  /**
+   * @brief Construct a new Telemetry logger
+   *
+   * @param period Drain period (ms)
+   */
+  Telemetry(uint32_t period = 20);
+
+  /**
+   * @brief Log a record on a channel
+   * @details Copies the payload into the channel's ring, no locks or allocation. Only call this
+   * from the one task that owns the channel.
+   *
+   * @tparam Channel Channel to log on
+   * @param payload Payload for the channel
+   * @return true The record was queued
+   * @return false Logging is off or the ring is full
+   */
+  template <TelemetryChannel Channel>
+  bool log(const TelemetryPayload<Channel>& payload)
+  {
+    using Payload = TelemetryPayload<Channel>;
+    static_assert(std::is_trivially_copyable_v<Payload>, "Payloads must be plain data");
+    static_assert(sizeof(Payload) <= sizeof(TelemetryRecord::payload), "Payload is too large");
+
+    if (!enabled_.load(std::memory_order_relaxed)) { return false; }
+
+    constexpr size_t index = static_cast<size_t>(Channel);
+    TelemetryRecord record;
+    record.timestamp = pros::millis();
+    record.channel = static_cast<uint8_t>(Channel);
+    record.size = sizeof(Payload);
+    record.sequence = sequences_[index]++;
+    std::memcpy(record.payload, &payload, sizeof(Payload));
+
+    return rings_[index].push(record);
+  }
+
+  /**
+   * @brief Log a message with deferred formatting
+   * @details Only the format id and the raw arguments are captured here. The drain formats the
+   * message for the message sink, and the SD / serial stream keeps it packed for the host.
+   *
+   * @tparam Format fmt style format string
+   * @param level Message level
+   * @param args Arguments (numbers, enums or bools, 20 bytes at most)
+   * @return true The message was queued
+   * @return false Logging is off or the ring is full
+   */
+  template <FixedString Format, typename... Args>
+  bool message(lemlib::Level level, const Args&... args)
+  {
+    using Signature = DeferredSignature<Args...>;
+    static_assert(Signature::packed_size <= sizeof(TelemetryMessage::args), "Too many arguments");
+    static_assert((fmt::format_string<const Args&...>(Format.data), true), "Bad format string");
+
+    if (!enabled_.load(std::memory_order_relaxed)) { return false; }
+
+    TelemetryMessage payload;
+    payload.format = DeferredFormatId<Format, Args...>::value;
+    payload.level = static_cast<uint8_t>(level);
+    payload.size = Signature::packed_size;
+    uint8_t* out = payload.args;
+    (packDeferredArg(out, args), ...);
+
+    TelemetryRecord record;
+    record.timestamp = pros::millis();
+    record.channel = static_cast<uint8_t>(TelemetryChannel::MESSAGE);
+    record.size = sizeof(TelemetryMessage);
+    record.sequence = message_sequence_.fetch_add(1, std::memory_order_relaxed);
+    std::memcpy(record.payload, &payload, sizeof(TelemetryMessage));
+
+    return messages_.push(record);
+  }
+
+  template <FixedString Format, typename... Args>
+  bool debug(const Args&... args)
+  {
+    return this->message<Format>(lemlib::Level::DEBUG, args...);
+  }
+
+  template <FixedString Format, typename... Args>
+  bool info(const Args&... args)
+  {
+    return this->message<Format>(lemlib::Level::INFO, args...);
+  }
+
+  template <FixedString Format, typename... Args>
+  bool warn(const Args&... args)
+  {
+    return this->message<Format>(lemlib::Level::WARN, args...);
+  }
+
+  template <FixedString Format, typename... Args>
+  bool error(const Args&... args)
+  {
+    return this->message<Format>(lemlib::Level::ERROR, args...);
+  }
+
+  /**
+   * @brief Send formatted messages to a lemlib sink (e.g. lemlib::infoSink()) from the drain
+   *
+   * @param sink Sink to log to, nullptr to stop
+   */
+  void setMessageSink(std::shared_ptr<lemlib::BaseSink> sink);
+
+  /**
+   * @brief Start logging to a sink
+   *
+   * @param sink Where to write the records
+   * @param path File to write when the sink is the SD card, nullptr for the next free
+   * /usd/telemetry_NNN.bin
+   * @return true The sink is open
+   * @return false The sink couldn't be opened (logging stays off)
+   */
+  bool open(TelemetrySink sink, const char* path = nullptr);
+
+  /**
+   * @brief Stop logging and close the sink
+   *
+   */
+  void close();
+
+  /**
+   * @brief Get the total number of records lost to full rings
+   *
+   * @return uint32_t Dropped records
+   */
+  uint32_t getDropped() const;
+
+ private:
+  /**
+   * @brief Empty every ring into the sink
+   *
+   */
+  void drain();
+
+  /**
+   * @brief Handle a deferred message on its way to the sinks
+   *
+   * @param record Message record
+   */
+  void drainMessage(const TelemetryRecord& record);
+
+  /**
+   * @brief Add a record to the write batch, writing the batch out when it fills
+   *
+   * @param record Record to write
+   */
+  void emit(const TelemetryRecord& record);
+
+  /**
+   * @brief Write out the batch
+   *
+   */
+  void flushBatch();
+
+  /**
+   * @brief Background thread impl
+   *
+   */
+  void run();
+};
+
+extern Telemetry telemetry;
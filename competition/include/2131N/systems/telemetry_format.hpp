@@ -0,0 +1,121 @@
+/**
+ * @file telemetry_format.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Record layout of the telemetry stream (shared with the host decoder)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// A stream is a TelemetryHeader followed by 32 byte TelemetryRecords. MESSAGE records only carry
+// a format id and packed arguments, the drain writes that format's definition as FORMAT records
+// before its first message in each stream.
+
+/**
+ * @brief Telemetry channels. Each sampled channel must only be logged from one task.
+ *
+ */
+enum class TelemetryChannel : uint8_t
+{
+  ODOMETRY,  // Chassis Monitor task
+  MCL,       // Mcl update task
+  INTAKE,    // Intake Update task
+  COUNT,     // Number of sampled channels
+
+  MESSAGE = 0xFE,  // Deferred log message, from any task
+  FORMAT = 0xFF,   // Piece of a deferred format's definition, written by the drain
+};
+
+/**
+ * @brief Payload layout of each channel, specialised once per channel
+ *
+ * @tparam Channel Channel the payload belongs to
+ */
+template <TelemetryChannel Channel>
+struct TelemetryPayload;
+
+template <>
+struct TelemetryPayload<TelemetryChannel::ODOMETRY>
+{
+  float x;                 // X position (in)
+  float y;                 // Y position (in)
+  float theta;             // Heading (deg)
+  float velocity;          // Forwards velocity (in/s)
+  float angular_velocity;  // Turn rate (rad/s)
+};
+
+template <>
+struct TelemetryPayload<TelemetryChannel::MCL>
+{
+  float x;         // Estimated x position (in)
+  float y;         // Estimated y position (in)
+  float variance;  // Weighted particle variance around the estimate (in^2)
+};
+
+template <>
+struct TelemetryPayload<TelemetryChannel::INTAKE>
+{
+  uint8_t state;           // Intake::states
+  uint8_t ball_detected;   // Bottom detector reading a ball
+  uint8_t anti_jam;        // Running the anti-jam reversal
+  uint8_t reserved;        // Padding
+  int16_t bottom_voltage;  // Bottom stage voltage (mV)
+  int16_t middle_voltage;  // Middle stage voltage (mV)
+  int16_t top_voltage;     // Top stage voltage (mV)
+};
+
+/**
+ * @brief Deferred log message, the arguments are formatted after they leave the ring
+ *
+ */
+struct TelemetryMessage
+{
+  uint16_t format;   // Id in deferred_formats
+  uint8_t level;     // lemlib::Level
+  uint8_t size;      // Bytes of packed arguments
+  uint8_t args[20];  // Packed arguments
+};
+
+/**
+ * @brief 20 bytes of a format's definition, "<signature>\0<format>\0" split across records
+ *
+ */
+struct TelemetryFormatChunk
+{
+  uint16_t format;  // Id in deferred_formats
+  uint16_t offset;  // Position of this chunk in the definition
+  char text[20];    // Definition text, null padded after the end
+};
+
+/**
+ * @brief Fixed size record as stored in the ring and written to the sink
+ *
+ */
+struct TelemetryRecord
+{
+  uint32_t timestamp;   // Time the record was logged (ms)
+  uint8_t channel;      // TelemetryChannel
+  uint8_t size;         // Bytes of payload in use
+  uint16_t sequence;    // Per channel count, gaps mean dropped records
+  uint8_t payload[24];  // Packed TelemetryPayload
+};
+static_assert(sizeof(TelemetryRecord) == 32, "Telemetry records must stay 32 bytes");
+
+/**
+ * @brief Written once at the start of every stream so a decoder can check the layout
+ *
+ */
+struct TelemetryHeader
+{
+  char magic[4] = {'T', 'L', 'M', '1'};
+  uint16_t record_size = sizeof(TelemetryRecord);
+  uint16_t channel_count = static_cast<uint16_t>(TelemetryChannel::COUNT);
+};
+static_assert(sizeof(TelemetryMessage) <= sizeof(TelemetryRecord::payload));
+static_assert(sizeof(TelemetryFormatChunk) <= sizeof(TelemetryRecord::payload));
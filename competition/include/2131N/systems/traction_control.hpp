@@ -0,0 +1,186 @@
+/**
+ * @file traction_control.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Limits how fast the drive sides change speed, backing off when the wheels slip (no pros)
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "2131N/utils/drive_curve.hpp"
+
+struct TractionSettings
+{
+  float max_accel;       // Fastest a side may speed up, keeps the robot from tipping (in/s^2)
+  float min_accel;       // Lowest the limit drops to while the wheels slip (in/s^2)
+  float slip_threshold;  // Wheel acceleration this far from the ground's counts as slip (in/s^2)
+  float backoff;         // Limit is multiplied by this every update that slips
+  float recovery;        // Limit grows back this fast while the wheels grip (in/s^2 per s)
+  float filter;          // Low pass on the measured accelerations (0 to 1, 1 for none)
+  float track_width;     // Distance between the drive sides (in)
+
+  // Share of the IMU's x and y axes that points forward (cos and sin of its mounting angle),
+  // used by the chassis to read forward_accel
+  float imu_forward_x;
+  float imu_forward_y;
+};
+
+/**
+ * @brief Drivetrain readings for one update
+ *
+ */
+struct TractionSample
+{
+  float left_velocity;   // Left wheel speed from the motors (in/s)
+  float right_velocity;  // Right wheel speed from the motors (in/s)
+  float forward_accel;   // Forward acceleration from the IMU, offset and all (in/s^2)
+  float heading;         // Heading, clockwise (rad)
+};
+
+/**
+ * @brief Rate limits each drive side's speed-up, with a limit that follows the grip available
+ * @details The IMU measures how fast the robot is really speeding up. Each side's wheels should
+ * match that, plus or minus the turn's share. When they speed up (or slow down) faster, they
+ * are spinning or skidding, so the side's limit is cut. While they grip, it grows back towards
+ * max_accel. A launch ends up at the fastest acceleration the carpet will take instead of a
+ * fixed slew that is either too soft or spins the wheels. The IMU's offset (mounting tilt) is
+ * learnt while the robot is at rest.
+ *
+ */
+class TractionController
+{
+ private:
+  struct Side
+  {
+    float limit = 0.0f;          // Acceleration limit (in/s^2)
+    float output = 0.0f;         // Rate limited target (in/s)
+    float last_velocity = 0.0f;  // Wheel speed at the last update (in/s)
+    float accel = 0.0f;          // Filtered wheel acceleration (in/s^2)
+    bool slipping = false;       // Slipped at the last update
+  };
+
+  TractionSettings settings_;  // Limits and thresholds
+
+  Side left_;   // Left side
+  Side right_;  // Right side
+
+  float accel_offset_ = 0.0f;  // IMU reading at rest (in/s^2)
+  float ground_accel_ = 0.0f;  // Filtered forward acceleration (in/s^2)
+  float last_heading_ = 0.0f;  // Heading at the last update (rad)
+  float turn_rate_ = 0.0f;     // Turn rate at the last update (rad/s)
+  float turn_accel_ = 0.0f;    // Filtered turn acceleration (rad/s^2)
+  bool primed_ = false;        // Has there been an update since the reset
+
+ public:
+  /**
+   * @brief Construct a new Traction Controller
+   *
+   * @param settings Limits and thresholds
+   */
+  explicit TractionController(const TractionSettings& settings) : settings_(settings)
+  {
+    left_.limit = right_.limit = settings_.max_accel;
+  }
+
+  /**
+   * @brief Start again from the sides' current speeds
+   *
+   * @param left_velocity Left wheel speed (in/s)
+   * @param right_velocity Right wheel speed (in/s)
+   */
+  void reset(float left_velocity, float right_velocity)
+  {
+    for (auto [side, velocity] : {std::pair{&left_, left_velocity}, {&right_, right_velocity}})
+    {
+      *side = {settings_.max_accel, velocity, velocity, 0.0f, false};
+    }
+    ground_accel_ = turn_rate_ = turn_accel_ = 0.0f;
+    primed_ = false;
+  }
+
+  /**
+   * @brief Limit the targets for this update
+   *
+   * @param left_target Left side target (in/s)
+   * @param right_target Right side target (in/s)
+   * @param sample Drivetrain readings
+   * @param dT Time since the last update (s)
+   * @return std::pair<float, float> Left and right targets to drive (in/s)
+   */
+  std::pair<float, float> update(
+      float left_target, float right_target, const TractionSample& sample, float dT)
+  {
+    if (!primed_)
+    {
+      // Nothing to differentiate yet
+      last_heading_ = sample.heading;
+      left_.last_velocity = sample.left_velocity;
+      right_.last_velocity = sample.right_velocity;
+      primed_ = true;
+    }
+
+    // At rest whatever the IMU reads is its offset
+    bool at_rest = std::abs(sample.left_velocity) < 0.5f &&
+                   std::abs(sample.right_velocity) < 0.5f && left_target == 0.0f &&
+                   right_target == 0.0f;
+    if (at_rest) { accel_offset_ += 0.05f * (sample.forward_accel - accel_offset_); }
+
+    float filter = settings_.filter;
+    ground_accel_ += filter * (sample.forward_accel - accel_offset_ - ground_accel_);
+
+    // Filtered the same way as the wheels, so both lag by the same amount
+    float turn_rate = (sample.heading - last_heading_) / dT;
+    last_heading_ = sample.heading;
+    turn_accel_ += filter * ((turn_rate - turn_rate_) / dT - turn_accel_);
+    turn_rate_ = turn_rate;
+
+    // Turning clockwise speeds the left side up and the right side down
+    float turn_share = turn_accel_ * settings_.track_width / 2.0f;
+    return {
+        this->step(left_, left_target, sample.left_velocity, ground_accel_ + turn_share, dT),
+        this->step(right_, right_target, sample.right_velocity, ground_accel_ - turn_share, dT)};
+  }
+
+  const TractionSettings& getSettings() const { return settings_; }
+  float getLeftLimit() const { return left_.limit; }
+  float getRightLimit() const { return right_.limit; }
+  bool isSlipping() const { return left_.slipping || right_.slipping; }
+
+ private:
+  /**
+   * @brief Update one side's limit and move its output towards the target (slowing is never
+   * limited)
+   *
+   * @param side Side
+   * @param target Target (in/s)
+   * @param velocity Wheel speed (in/s)
+   * @param ground_accel Acceleration of the ground under the side (in/s^2)
+   * @param dT Time since the last update (s)
+   * @return float Output (in/s)
+   */
+  float step(Side& side, float target, float velocity, float ground_accel, float dT)
+  {
+    float accel = (velocity - side.last_velocity) / dT;
+    side.last_velocity = velocity;
+    side.accel += settings_.filter * (accel - side.accel);
+
+    side.slipping = std::abs(side.accel - ground_accel) > settings_.slip_threshold;
+    if (side.slipping)
+    {
+      side.limit = std::max(settings_.min_accel, side.limit * settings_.backoff);
+    }
+    else { side.limit = std::min(settings_.max_accel, side.limit + settings_.recovery * dT); }
+
+    // Only speeding up is limited, letting go or reversing still stops the side at once
+    side.output = slewTowards(side.output, target, side.limit * dT);
+    return side.output;
+  }
+};
@@ -0,0 +1,180 @@
+/**
+ * @file triggers.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Spatial triggers that fire subsystem actions during motions
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "2131N/systems/chassis.hpp"
+#include "2131N/systems/intake.hpp"
+#include "pros/rtos.hpp"
+
+struct TriggerCondition
+{
+  enum class Type
+  {
+    TRAVELED,       // Distance along the current motion >= value
+    NEAR,           // Within value of (x, y), predicted lead_time ahead
+    HEADING,        // Heading within value of theta
+    BALL_DETECTED,  // Intake detector sees a ball
+  };
+
+  Type type;
+  float x = 0.0f;          // Point x (in)
+  float y = 0.0f;          // Point y (in)
+  float theta = 0.0f;      // Target heading (deg)
+  float value = 0.0f;      // Distance, radius or heading tolerance
+  float lead_time = 0.0f;  // How far ahead to predict the pose (ms)
+
+  /**
+   * @brief Fire once the current motion has travelled a distance
+   *
+   * @param distance Distance along the motion (in)
+   * @return TriggerCondition Condition
+   */
+  static TriggerCondition traveled(float distance);
+
+  /**
+   * @brief Fire once the chassis is within a radius of a point
+   *
+   * @param x X position of the point (in)
+   * @param y Y position of the point (in)
+   * @param radius Radius around the point (in)
+   * @param lead_time Latency of the action, the pose is predicted this far ahead (ms)
+   * @return TriggerCondition Condition
+   */
+  static TriggerCondition near(float x, float y, float radius, float lead_time = 0.0f);
+
+  /**
+   * @brief Fire once the chassis heading is within a tolerance of a heading
+   *
+   * @param theta Target heading (deg)
+   * @param epsilon Tolerance (deg)
+   * @return TriggerCondition Condition
+   */
+  static TriggerCondition heading(float theta, float epsilon);
+
+  /**
+   * @brief Fire once the intake detector sees a ball
+   *
+   * @return TriggerCondition Condition
+   */
+  static TriggerCondition ballDetected();
+};
+
+class TriggerEngine
+{
+ public:
+  static constexpr size_t kMaxTriggers = 16;  // Triggers that can be armed at once
+
+ private:
+  struct Slot
+  {
+    TriggerCondition condition{TriggerCondition::Type::TRAVELED};
+    std::function<void()> action;  // Action to run when the condition is met
+    uint32_t expiry = 0;           // Time the trigger is dropped without firing (ms)
+    bool fire_on_expire = false;   // Run the action anyway when the trigger expires
+    bool armed = false;            // Is the slot waiting to fire
+  };
+
+  Chassis* chassis_;  // Chassis the pose comes from
+  Intake* intake_;    // Intake the ball detector comes from
+
+  std::array<Slot, kMaxTriggers> slots_;  // Trigger storage
+  pros::Mutex mutex_;                     // Guards the slots between tasks
+
+  uint32_t period_;  // Evaluation period (ms)
+  pros::Task task_;  // High priority thread that evaluates the triggers
+
+ public:
+  /**
+   * @brief Construct a new Trigger Engine
+   *
+   * @param chassis Chassis to read the pose from
+   * @param intake Intake to read the ball detector from
+   * @param period Evaluation period (ms)
+   */
+  TriggerEngine(Chassis* chassis, Intake* intake, uint32_t period = 10);
+
+  /**
+   * @brief Arm an action to run once a condition is met
+   *
+   * @param condition Condition to wait for
+   * @param action Action to run (keep it short, it runs on the trigger thread)
+   * @param timeout Time after which the trigger expires (ms)
+   * @param fire_on_expire Run the action when the trigger expires instead of dropping it, for
+   * actions the routine can't go on without
+   * @return true The trigger was armed
+   * @return false Every slot is in use
+   */
+  bool schedule(
+      TriggerCondition condition,
+      std::function<void()> action,
+      int timeout = 5000,
+      bool fire_on_expire = false);
+
+  /**
+   * @brief Drop every armed trigger
+   *
+   */
+  void clear();
+
+  /**
+   * @brief Expire every armed trigger now, running the fire_on_expire actions on this task
+   *
+   */
+  void expire();
+
+  /**
+   * @brief Block until a condition is met
+   *
+   * @param condition Condition to wait for
+   * @param timeout Longest time to wait (ms)
+   * @return true The condition was met
+   * @return false The wait timed out
+   */
+  bool waitFor(TriggerCondition condition, int timeout = 5000);
+
+  /**
+   * @brief Get the number of armed triggers
+   *
+   * @return size_t Armed triggers
+   */
+  size_t pending();
+
+  /**
+   * @brief Block until every armed trigger has fired or expired
+   *
+   * @param timeout Longest time to wait (ms)
+   * @return true No triggers are left
+   * @return false The wait timed out
+   */
+  bool waitUntilIdle(int timeout = 5000);
+
+ private:
+  /**
+   * @brief Check a condition against the current state of the robot
+   *
+   * @param condition Condition to check
+   * @return true Condition met
+   * @return false Condition not met
+   */
+  bool evaluate(const TriggerCondition& condition);
+
+  /**
+   * @brief Background thread impl
+   *
+   */
+  void run();
+};
@@ -0,0 +1,114 @@
+/**
+ * @file field_view.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief LVGL view of the field with the odometry pose and the MCL particle cloud
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "2131N/systems/chassis.hpp"
+#include "2131N/systems/mcl/mcl.hpp"
+#include "2131N/ui/screen.hpp"
+#include "liblvgl/lvgl.h"
+
+class FieldView
+{
+ public:
+  static constexpr int32_t kFieldPixels = 240;   // Field is drawn 240x240 on the left of the display
+  static constexpr double kFieldInches = 144.0;  // Field width and height
+
+ private:
+  Chassis* chassis_;                                // Odometry pose
+  Screen* screen_;                                  // Auto selector, paused while the view is up
+  std::function<void(MclSnapshot&)> mcl_snapshot_;  // Copies the latest MCL snapshot
+
+  MclSnapshot snapshot_;              // Snapshot being drawn (LVGL thread only)
+  uint32_t period_;                   // Redraw period (ms)
+  std::atomic<bool> visible_{false};  // Is the view on the display
+
+  lv_obj_t* view_ = nullptr;      // LVGL screen holding the view
+  lv_obj_t* canvas_ = nullptr;    // Field drawing
+  lv_obj_t* label_ = nullptr;     // Numbers next to the field
+  lv_obj_t* previous_ = nullptr;  // LVGL screen to go back to
+  lv_timer_t* timer_ = nullptr;   // Redraws the view on LVGL's own thread
+
+ public:
+  /**
+   * @brief Construct a new Field View
+   *
+   * @param chassis Chassis to show the odometry pose of
+   * @param screen Auto selector to pause while the view is shown
+   * @param mcl_snapshot Copies the latest MCL snapshot (must not block)
+   * @param period Redraw period (ms)
+   */
+  FieldView(
+      Chassis* chassis,
+      Screen* screen,
+      std::function<void(MclSnapshot&)> mcl_snapshot,
+      uint32_t period = 100);
+
+  /**
+   * @brief Put the view on the display, tapping it goes back to the auto selector
+   * @details Only queues the switch, the view is built and loaded on LVGL's thread.
+   *
+   */
+  void show();
+
+  /**
+   * @brief Go back to the auto selector
+   *
+   */
+  void hide();
+
+  bool isVisible() const { return visible_.load(); }
+
+ private:
+  /**
+   * @brief Build the LVGL objects the first time the view is shown (LVGL thread)
+   *
+   */
+  void create();
+
+  /**
+   * @brief Load the view onto the display (LVGL thread)
+   *
+   */
+  void showView();
+
+  /**
+   * @brief Load the previous screen back (LVGL thread)
+   *
+   */
+  void hideView();
+
+  /**
+   * @brief Draw the latest snapshot (LVGL thread)
+   *
+   */
+  void draw();
+
+  /**
+   * @brief Convert field coordinates to canvas pixels
+   *
+   * @param point Field position (in)
+   * @return lv_point_precise_t Canvas position (px)
+   */
+  static lv_point_precise_t toCanvas(const Point& point);
+
+  static void onTimer(lv_timer_t* timer);
+
+  static void onClick(lv_event_t* event);
+
+  static void onShow(void* view);
+
+  static void onHide(void* view);
+};
@@ -11,13 +11,18 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
-#include <map>
 #include <string>
+#include <tuple>
+#include <vector>
 
-#include "2131N/utils/change_detector.hpp"
+#include "2131N/ui/touch_dispatcher.hpp"
+#include "2131N/utils/deferred_format.hpp"
+#include "fmt/format.h"
 #include "pros/colors.hpp"
 #include "pros/rtos.hpp"
 #include "pros/screen.h"
@@ -29,9 +34,41 @@ struct AutoInfo
   std::function<void(bool)> autonCallback;  // Callback to Autonomous Code
 };
 
+/**
+ * @brief Value shown on the screen, formatted into a fixed buffer every frame
+ *
+ */
+struct ScreenTelemetry
+{
+  const char* label;                                    // Shown before the value
+  std::function<size_t(char* out, size_t size)> write;  // Formats the value, returns its length
+};
+
+/**
+ * @brief Wrap a single value so every telemetry source can be used as a tuple
+ *
+ */
+template <typename T>
+auto asTelemetryTuple(const T& value)
+{
+  return std::tuple<T>(value);
+}
+
+template <typename... Ts>
+auto asTelemetryTuple(const std::tuple<Ts...>& values)
+{
+  return values;
+}
+
 class RectButton
 {
+ public:
+  static constexpr size_t kMaxLines = 10;    // Lines of text a button can hold
+  static constexpr size_t kLineLength = 64;  // Characters per line, including the terminator
+
  private:
+  using Line = std::array<char, kLineLength>;
+
   int16_t x_, y_, width_, height_;     // Rectangle Characteristics
   uint8_t boarder_width_;              // Pen Boarder Width
   pros::Color boarder_color_;          // Color of Boarder Width
@@ -40,9 +77,15 @@ class RectButton
   int16_t x_padding_, y_padding_;      // Padding from button edge to text
   pros::text_format_e_t text_format_;  // Text Format (ie. large, medium, small)
   std::function<void()> callback_;     // Callback for when Button is pressed
-  bool ignore_press_ = true;           // ALlows for update despite not being pressed
   bool pressed_ = false;               // Is Button Pressed?
 
+  std::array<Line, kMaxLines> lines_{};           // Lines of text to show
+  std::array<Line, kMaxLines> rendered_lines_{};  // Lines of text currently on the screen
+  size_t line_count_ = 0;                         // Lines to show
+  size_t rendered_line_count_ = 0;                // Lines currently on the screen
+  size_t text_line_count_ = 0;                    // Lines that come from text_
+  bool dirty_ = true;                             // Background and boarder need a redraw
+
  public:
   /**
    * @brief Construct a new Rect Button
@@ -75,12 +118,22 @@ class RectButton
       std::function<void()> callback = []() {});
 
   /**
-   * @brief Set the Text of a Button
+   * @brief Set the Text of a Button, drawn on the next update
+   * @details Drops any lines added with appendLine. The text is only split into lines when it
+   * changes.
    *
    * @param new_text New text to be displayed
    */
   void setText(const std::string& new_text);
 
+  /**
+   * @brief Add a line after the text, for values that change every frame
+   *
+   * @return char* Line to write (kLineLength characters with the terminator), nullptr if the
+   * button is full
+   */
+  char* appendLine();
+
   /**
    * @brief Set the Background Fill Color object
    *
@@ -88,6 +141,13 @@ class RectButton
    */
   void setFillColor(pros::Color new_fill_color);
 
+  /**
+   * @brief Get presses from a touch dispatcher
+   *
+   * @param dispatcher Dispatcher to add the button's rectangle to
+   */
+  void attach(TouchDispatcher& dispatcher);
+
   /**
    * @brief get whether or not the button is pressed
    *
@@ -97,10 +157,33 @@ class RectButton
   bool getPressed();
 
   /**
-   * @brief Update a button (draw, get presses, etc)
+   * @brief Redraw the whole button on the next update (something else drew over it)
+   *
+   */
+  void invalidate();
+
+  /**
+   * @brief Draw a button
+   * @details Only what changed since the last update is drawn: the whole button after a color
+   * change, otherwise just the lines of text that are different. Presses come from attach().
    *
    */
   void update();
+
+ private:
+  /**
+   * @brief Get the height of a line of text in the button's text format
+   *
+   * @return int16_t Line height in pixels
+   */
+  int16_t getLineHeight() const;
+
+  /**
+   * @brief Clear one line of text back to the fill color
+   *
+   * @param line Line index
+   */
+  void eraseLine(size_t line);
 };
 
 class Screen
@@ -109,11 +192,13 @@ class Screen
   std::vector<AutoInfo> autos_;            // List of auto info
   size_t current_auto_index_ = size_t(0);  // Current index of list
 
-  std::map<std::string, std::function<std::string()>>
-      telemetry_data_;  // Map of Telemetries (label, function that returns text to be displayed
-                        // every loop)
+  std::vector<ScreenTelemetry> telemetry_data_;  // Values shown under the description
+
+  std::vector<std::string> drivers_;             // Names of the driver profiles
+  std::atomic<size_t> current_driver_index_{0};  // Selected driver
 
   RectButton name_button_;         // Button that displays the name of the selected Autonomous
+  RectButton driver_button_;       // Button that shows and cycles the selected driver
   RectButton description_button_;  // Button that shows a description of the selected Autonomous
   RectButton color_button_;        // Button that toggles the color of the alliance
 
@@ -122,7 +207,9 @@ class Screen
   pros::Task screen_task_;    // Thread to run the screen task
   bool initialized_ = false;  // Has the screen been initialized?
 
-  ChangeDetector<bool> screen_press_detector_;  // Change detector to get button presses
+  std::atomic<bool> paused_{false};  // Another view (FieldView) owns the display
+
+  TouchDispatcher touch_dispatcher_;  // Sends touches to the buttons
 
  public:
   /**
@@ -144,12 +231,49 @@ class Screen
    * @param autos List of AutoInfo Structs ie. {name, description, callback}
    */
   void addAutos(const std::vector<AutoInfo>& autos);
+
+  /**
+   * @brief Add driver profiles that can be picked on the screen
+   *
+   * @param names Profile names, in the order getDriver() indexes them
+   */
+  void addDrivers(const std::vector<std::string>& names);
+
   /**
-   * @brief Add list of telemetries to be shown on the screen
+   * @brief Get the selected driver profile (any task)
    *
-   * @param telemetryData Map of (index, function with string return)
+   * @return size_t Index into the names given to addDrivers
    */
-  void addTelemetries(const std::map<std::string, std::function<std::string()>>& telemetry_data);
+  size_t getDriver() const { return current_driver_index_.load(); }
+
+  /**
+   * @brief Add a value to be shown on the screen as "label: value"
+   * @details The format is checked at compile time and the value is formatted straight into
+   * the button's line, nothing is allocated while the screen runs.
+   *
+   * @tparam Format fmt style format string for the value(s)
+   * @param label Label (must outlive the screen, e.g. a string literal)
+   * @param source Returns a number, or a std::tuple of numbers, for the format
+   */
+  template <FixedString Format, typename Source>
+  void addTelemetry(const char* label, Source source)
+  {
+    using Values = decltype(asTelemetryTuple(source()));
+    static_assert(
+        ([]<typename... Args>(std::tuple<Args...>*) {
+          return (fmt::format_string<const Args&...>(Format.data), true);
+        })(static_cast<Values*>(nullptr)),
+        "Bad format string");
+
+    telemetry_data_.push_back(
+        {label, [source](char* out, size_t size) -> size_t {
+           return std::apply(
+               [&](const auto&... values) {
+                 return fmt::format_to_n(out, size, fmt::runtime(Format.data), values...).size;
+               },
+               asTelemetryTuple(source()));
+         }});
+  }
 
   /**
    * @brief Get the Current Auto Callback object
@@ -180,7 +304,26 @@ class Screen
    */
   bool getRedTeam();
 
+  /**
+   * @brief Stop drawing while another view is on the display, everything is redrawn on resume
+   *
+   * @param paused Stop drawing
+   */
+  void setPaused(bool paused);
+
  protected:
+  /**
+   * @brief Show the next auto in the list
+   *
+   */
+  void cycleAuto();
+
+  /**
+   * @brief Select the next driver profile
+   *
+   */
+  void cycleDriver();
+
   /**
    * @brief Background thread impl
    *
@@ -0,0 +1,134 @@
+/**
+ * @file touch_dispatcher.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Turns brain screen touches into press/release events for on-screen regions
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "2131N/utils/spsc_ring.hpp"
+#include "pros/rtos.hpp"
+
+enum class TouchEventType : uint8_t
+{
+  PRESS,
+  RELEASE
+};
+
+struct TouchEvent
+{
+  TouchEventType type;  // Finger went down or came up
+  int16_t x, y;         // Where on the screen (px)
+};
+
+/**
+ * @brief Gets touches from PROS touch callbacks and hands them to the region under the finger
+ * @details The callbacks read the touch status once per press or release and queue it. The
+ * owning task calls dispatch() to hit-test the queued touches and run the handlers, so handlers
+ * run on that task and can draw. Regions are found through a coarse grid over the screen, each
+ * cell holding a mask of the regions that overlap it.
+ *
+ */
+class TouchDispatcher
+{
+ public:
+  static constexpr size_t kMaxRegions = 16;           // Regions that can be added
+  static constexpr int16_t kCellSize = 60;            // Grid cell size (px)
+  static constexpr size_t kCellsX = 480 / kCellSize;  // Grid columns
+  static constexpr size_t kCellsY = 240 / kCellSize;  // Grid rows
+
+  using Handler = std::function<void(const TouchEvent&)>;
+
+ private:
+  struct Region
+  {
+    int16_t x, y, width, height;  // Rectangle (edges included)
+    Handler on_press;             // Called when a press starts inside
+    Handler on_release;           // Called when a press that started inside ends
+  };
+
+  std::array<Region, kMaxRegions> regions_;          // Regions, later ones are on top
+  size_t region_count_ = 0;                          // Regions added
+  std::array<uint16_t, kCellsX * kCellsY> cells_{};  // Regions overlapping each grid cell
+
+  SpscRing<TouchEvent, 16> events_;    // Touches from the PROS callbacks, waiting for dispatch()
+  pros::Task* notify_task_ = nullptr;  // Woken on every touch
+  bool touching_ = false;              // A press has been dispatched without its release
+  int pressed_region_ = -1;            // Region that got the press, -1 if none
+
+  static TouchDispatcher* instance_;  // Dispatcher the PROS callbacks feed
+
+  static_assert(kMaxRegions <= 16, "Cell masks are 16 bits");
+
+ public:
+  /**
+   * @brief Add a region of the screen to get touches
+   *
+   * @param x Left edge (px)
+   * @param y Top edge (px)
+   * @param width Width (px)
+   * @param height Height (px)
+   * @param on_press Called when a press starts inside the region
+   * @param on_release Called when that press ends, wherever the finger is
+   * @return true The region was added
+   * @return false There is no room for another region
+   */
+  bool addRegion(
+      int16_t x,
+      int16_t y,
+      int16_t width,
+      int16_t height,
+      Handler on_press,
+      Handler on_release = [](const TouchEvent&) {});
+
+  /**
+   * @brief Register the PROS touch callbacks, only one dispatcher can be started
+   *
+   * @param notify_task Task to wake when a touch comes in (the one calling dispatch())
+   */
+  void start(pros::Task* notify_task);
+
+  /**
+   * @brief Run the handlers for every touch since the last call
+   *
+   * @return size_t Touches handled
+   */
+  size_t dispatch();
+
+  /**
+   * @brief Drop every waiting touch, ending a press that is still held
+   *
+   */
+  void clear();
+
+  /**
+   * @brief Find the top region at a point
+   *
+   * @param x X (px)
+   * @param y Y (px)
+   * @return int Region index, -1 if none
+   */
+  int hitTest(int16_t x, int16_t y) const;
+
+ private:
+  /**
+   * @brief Queue the current touch status (PROS display task)
+   *
+   * @param type Press or release
+   */
+  void queue(TouchEventType type);
+
+  static void onPress();
+
+  static void onRelease();
+};
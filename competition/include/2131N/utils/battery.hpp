@@ -0,0 +1,34 @@
+/**
+ * @file battery.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Battery sag compensation for motor voltage commands
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+
+#include "pros/misc.hpp"
+
+/**
+ * @brief Scale a voltage command so the motor sees the same voltage at any charge
+ * @details Motor voltage commands are a duty cycle of the 12V range, so a sagging battery delivers
+ * less than was asked for. The command is scaled by 12V over the measured battery voltage.
+ *
+ * @param voltage Voltage the motor should see (mV)
+ * @return float Voltage to command (mV), clamped to +-12000
+ */
+inline float batteryCompensate(float voltage)
+{
+  float battery = pros::battery::get_voltage();
+
+  // No reading (or a nonsense one), leave the command as is
+  if (battery < 6000.0f) { return std::clamp(voltage, -12000.0f, 12000.0f); }
+
+  return std::clamp(voltage * 12000.0f / battery, -12000.0f, 12000.0f);
+}
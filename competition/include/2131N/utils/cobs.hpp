@@ -0,0 +1,88 @@
+/**
+ * @file cobs.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Consistent overhead byte stuffing, so a zero byte can mark the end of every frame
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Largest encoding of a frame, one extra byte per 254 bytes plus the first code byte
+ *
+ * @param length Unencoded length
+ * @return constexpr size_t Encoded length at most
+ */
+constexpr size_t cobsMaxEncodedSize(size_t length) { return length + length / 254 + 1; }
+
+/**
+ * @brief Encode a frame so it contains no zero bytes
+ *
+ * @param in Frame
+ * @param length Frame length
+ * @param out Encoded frame, cobsMaxEncodedSize(length) bytes of space
+ * @return size_t Encoded length (no delimiter is added)
+ */
+inline size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out)
+{
+  size_t code_index = 0;  // Where the current run's code byte goes
+  size_t write = 1;
+  uint8_t code = 1;
+
+  for (size_t read = 0; read < length; read++)
+  {
+    if (in[read] == 0)
+    {
+      out[code_index] = code;
+      code_index = write++;
+      code = 1;
+      continue;
+    }
+
+    out[write++] = in[read];
+    if (++code == 0xFF)
+    {
+      // Longest run a code byte can describe
+      out[code_index] = code;
+      code_index = write++;
+      code = 1;
+    }
+  }
+
+  out[code_index] = code;
+  return write;
+}
+
+/**
+ * @brief Decode a frame (without its delimiter)
+ *
+ * @param in Encoded frame
+ * @param length Encoded length
+ * @param out Decoded frame, length bytes of space
+ * @return size_t Decoded length, 0 if the frame is malformed
+ */
+inline size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out)
+{
+  size_t read = 0;
+  size_t write = 0;
+
+  while (read < length)
+  {
+    uint8_t code = in[read++];
+    if (code == 0 || read + code - 1 > length) { return 0; }
+
+    for (uint8_t i = 1; i < code; i++) { out[write++] = in[read++]; }
+
+    // A full run carries no implied zero, neither does the end of the frame
+    if (code != 0xFF && read < length) { out[write++] = 0; }
+  }
+
+  return write;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file command_cache.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Device commands that are only sent when they change, with a keep-alive refresh
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "pros/abstract_motor.hpp"
+#include "pros/adi.hpp"
+
+/**
+ * @brief Last command sent to a motor (or motor group), so repeating it costs nothing
+ * @details Every command is a smart port write. Loops that set the same voltage every 10ms
+ * only send it when the value or mode changes, and again every keep-alive period in case the
+ * motor missed it (unplugged, brownout). Only one task should command a motor through this.
+ *
+ */
+class MotorCommand
+{
+ public:
+  static constexpr uint32_t kKeepAlive = 100;  // Resend an unchanged command this often (ms)
+
+ private:
+  enum class Mode : uint8_t
+  {
+    NONE,      // Nothing sent yet (or invalidated)
+    VOLTAGE,   // move_voltage
+    VELOCITY,  // move_velocity
+    BRAKE      // brake with brake_mode_
+  };
+
+  pros::AbstractMotor* motor_;  // Motor being commanded
+  uint32_t keep_alive_;         // Resend period (ms)
+
+  Mode mode_ = Mode::NONE;                                   // Last command sent
+  int32_t value_ = 0;                                        // Voltage (mV) or velocity (rpm) sent
+  pros::MotorBrake brake_mode_ = pros::MotorBrake::invalid;  // Brake mode set on the motor
+  uint32_t last_sent_ = 0;                                   // When the command was last sent (ms)
+  uint32_t sent_ = 0;                                        // Commands sent
+  uint32_t skipped_ = 0;                                     // Commands that were already in place
+
+ public:
+  /**
+   * @brief Construct a new Motor Command
+   *
+   * @param motor Motor or motor group to command
+   * @param keep_alive Resend an unchanged command this often (ms)
+   */
+  explicit MotorCommand(pros::AbstractMotor* motor, uint32_t keep_alive = kKeepAlive);
+
+  /**
+   * @brief Set the motor voltage
+   *
+   * @param voltage Voltage (mV)
+   * @return true The command was sent
+   * @return false The motor already had it
+   */
+  bool moveVoltage(int32_t voltage);
+
+  /**
+   * @brief Set the motor velocity
+   *
+   * @param velocity Velocity (rpm)
+   * @return true The command was sent
+   * @return false The motor already had it
+   */
+  bool moveVelocity(int32_t velocity);
+
+  /**
+   * @brief Stop the motor, setting the brake mode first if it is different
+   *
+   * @param mode Brake mode
+   * @return true The command was sent
+   * @return false The motor was already stopped this way
+   */
+  bool brake(pros::MotorBrake mode);
+
+  /**
+   * @brief Send the next command whatever it is (something else commanded the motor)
+   *
+   */
+  void invalidate();
+
+  int32_t getValue() const { return value_; }
+  uint32_t getSent() const { return sent_; }
+  uint32_t getSkipped() const { return skipped_; }
+
+ private:
+  /**
+   * @brief Check if a command has to go out, and record it as sent if so
+   *
+   * @param mode Command mode
+   * @param value Command value
+   * @return true Send it
+   * @return false The motor already has it
+   */
+  bool due(Mode mode, int32_t value);
+};
+
+/**
+ * @brief Solenoid writes that are skipped when it is already in that state
+ * @details Uses the state pros::adi::Pneumatics keeps, so writes made straight to the solenoid
+ * elsewhere are seen too.
+ *
+ */
+class PneumaticCommand
+{
+ public:
+  static constexpr uint32_t kKeepAlive = 500;  // Rewrite an unchanged state this often (ms)
+
+ private:
+  pros::adi::Pneumatics* pneumatic_;  // Solenoid being commanded
+  uint32_t keep_alive_;               // Rewrite period (ms)
+
+  bool known_ = false;      // Has anything been written yet
+  uint32_t last_sent_ = 0;  // When the state was last written (ms)
+
+ public:
+  /**
+   * @brief Construct a new Pneumatic Command
+   *
+   * @param pneumatic Solenoid to command
+   * @param keep_alive Rewrite an unchanged state this often (ms)
+   */
+  explicit PneumaticCommand(pros::adi::Pneumatics* pneumatic, uint32_t keep_alive = kKeepAlive);
+
+  /**
+   * @brief Extend or retract
+   *
+   * @param extended Extend
+   * @return true The state was written
+   * @return false The solenoid already had it
+   */
+  bool set(bool extended);
+
+  bool extend() { return this->set(true); }
+  bool retract() { return this->set(false); }
+  bool toggle() { return this->set(!pneumatic_->is_extended()); }
+  bool isExtended() const { return pneumatic_->is_extended(); }
+
+  void invalidate() { known_ = false; }
+};
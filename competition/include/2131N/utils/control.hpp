@@ -0,0 +1,416 @@
+/**
+ * @file control.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Header only controllers and filters with compile time gains, for any number of channels
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "2131N/utils/fixed.hpp"
+
+/*
+ * Every class here takes its scalar type (float, double or Fixed), its gains and a channel count
+ * as template arguments. The gains are baked in when the class is compiled, so a zero gain
+ * removes its term and the loop period folds into the gains (no divides by dT at run time).
+ * State is kept one array per term, across channels, so update() over every channel is a
+ * straight loop over arrays. Nothing is const, so they copy and assign like any other value.
+ */
+
+/**
+ * @brief Gains for StaticPid, same meaning as PID's
+ *
+ */
+struct PidGains
+{
+  float kP = 0.0f;               // Proportional gain
+  float kI = 0.0f;               // Integral gain (per ms)
+  float kD = 0.0f;               // Derivative gain (per ms)
+  float integral_windup = 0.0f;  // Integral only builds while the error is under this, 0 for always
+  float period = 10.0f;          // Time between updates (ms)
+};
+
+/**
+ * @brief Gains for StaticFeedforward, same meaning as VelocityController's
+ *
+ */
+struct FeedforwardGains
+{
+  float kS = 0.0f;       // Static gain
+  float kV = 0.0f;       // Velocity gain
+  float kA = 0.0f;       // Acceleration gain (per ms)
+  float period = 10.0f;  // Time between updates (ms)
+};
+
+struct SlewGains
+{
+  float rate = 0.0f;     // Fastest the output can change (per second), 0 for no limit
+  float period = 10.0f;  // Time between updates (ms)
+};
+
+struct EmaGains
+{
+  float alpha = 1.0f;  // Share of each new sample (0 to 1, 1 for no filtering)
+};
+
+template <typename T>
+constexpr T controlAbs(T value)
+{
+  return value < T(0) ? -value : value;
+}
+
+template <typename T>
+constexpr T controlSign(T value)
+{
+  if (value > T(0)) { return T(1); }
+  if (value < T(0)) { return T(-1); }
+  return T(0);
+}
+
+/**
+ * @brief PID on the error, trapezoid integral reset outside the windup band
+ *
+ * @tparam T Scalar type
+ * @tparam Gains Gains
+ * @tparam Channels Independent loops run together
+ */
+template <typename T, PidGains Gains, size_t Channels = 1>
+class StaticPid
+{
+ public:
+  using Values = std::array<T, Channels>;
+
+ private:
+  static constexpr bool kUsesI = Gains.kI != 0.0f;
+  static constexpr bool kUsesD = Gains.kD != 0.0f;
+  static constexpr bool kWindup = Gains.integral_windup != 0.0f;
+
+  static constexpr T kP = T(Gains.kP);
+  static constexpr T kHalfIdT = T(Gains.kI * Gains.period / 2.0f);  // Trapezoid rule
+  static constexpr T kDOverdT = T(Gains.kD / Gains.period);
+  static constexpr T kWindupLimit = T(Gains.integral_windup);
+
+  Values previous_error_{};  // Error at the last update
+  Values integral_{};        // Integral term
+
+ public:
+  /**
+   * @brief Run every channel
+   *
+   * @param error Target - actual for each channel
+   * @return Values Outputs
+   */
+  constexpr Values update(const Values& error)
+  {
+    Values output;
+    for (size_t i = 0; i < Channels; i++) { output[i] = this->step(i, error[i]); }
+    return output;
+  }
+
+  constexpr T update(T error)
+    requires(Channels == 1)
+  {
+    return this->step(0, error);
+  }
+
+  constexpr void reset()
+  {
+    previous_error_ = {};
+    integral_ = {};
+  }
+
+  constexpr void clearIntegral(size_t channel) { integral_[channel] = T(0); }
+
+ private:
+  constexpr T step(size_t i, T error)
+  {
+    T output = kP * error;
+
+    if constexpr (kUsesI)
+    {
+      if (!kWindup || controlAbs(error) < kWindupLimit)
+      {
+        integral_[i] += kHalfIdT * (error + previous_error_[i]);
+      }
+      else { integral_[i] = T(0); }
+      output += integral_[i];
+    }
+
+    if constexpr (kUsesD) { output += kDOverdT * (error - previous_error_[i]); }
+
+    previous_error_[i] = error;
+    return output;
+  }
+};
+
+/**
+ * @brief kS, kV and kA feedforward, no state
+ *
+ * @tparam T Scalar type
+ * @tparam Gains Gains
+ * @tparam Channels Independent channels run together
+ */
+template <typename T, FeedforwardGains Gains, size_t Channels = 1>
+class StaticFeedforward
+{
+ public:
+  using Values = std::array<T, Channels>;
+
+ private:
+  static constexpr T kS = T(Gains.kS);
+  static constexpr T kV = T(Gains.kV);
+  static constexpr T kAOverdT = T(Gains.kA / Gains.period);
+
+ public:
+  /**
+   * @brief Run every channel
+   *
+   * @param target Target for each channel
+   * @param current Current value of each channel
+   * @return Values Outputs
+   */
+  static constexpr Values update(const Values& target, const Values& current)
+  {
+    Values output;
+    for (size_t i = 0; i < Channels; i++) { output[i] = step(target[i], current[i]); }
+    return output;
+  }
+
+  static constexpr T update(T target, T current)
+    requires(Channels == 1)
+  {
+    return step(target, current);
+  }
+
+ private:
+  static constexpr T step(T target, T current)
+  {
+    T output = kV * target;
+    if constexpr (Gains.kS != 0.0f) { output += kS * controlSign(target); }
+    if constexpr (Gains.kA != 0.0f) { output += kAOverdT * (target - current); }
+    return output;
+  }
+};
+
+/**
+ * @brief Limits how fast the output can change
+ *
+ * @tparam T Scalar type
+ * @tparam Gains Rate and period
+ * @tparam Channels Independent channels run together
+ */
+template <typename T, SlewGains Gains, size_t Channels = 1>
+class StaticSlew
+{
+ public:
+  using Values = std::array<T, Channels>;
+
+ private:
+  static constexpr T kStep = T(Gains.rate * Gains.period / 1000.0f);
+
+  Values output_{};  // Last output
+
+ public:
+  /**
+   * @brief Run every channel
+   *
+   * @param target Value wanted for each channel
+   * @return Values Outputs
+   */
+  constexpr Values update(const Values& target)
+  {
+    for (size_t i = 0; i < Channels; i++) { output_[i] = this->step(i, target[i]); }
+    return output_;
+  }
+
+  constexpr T update(T target)
+    requires(Channels == 1)
+  {
+    return output_[0] = this->step(0, target);
+  }
+
+  constexpr void reset(T value = T(0)) { output_.fill(value); }
+  constexpr void set(size_t channel, T value) { output_[channel] = value; }
+
+ private:
+  constexpr T step(size_t i, T target) const
+  {
+    if constexpr (Gains.rate == 0.0f) { return target; }
+    else { return output_[i] + std::clamp(target - output_[i], -kStep, kStep); }
+  }
+};
+
+/**
+ * @brief Exponential moving average
+ *
+ * @tparam T Scalar type
+ * @tparam Gains Smoothing
+ * @tparam Channels Independent channels run together
+ */
+template <typename T, EmaGains Gains, size_t Channels = 1>
+class StaticEma
+{
+ public:
+  using Values = std::array<T, Channels>;
+
+ private:
+  static constexpr T kAlpha = T(Gains.alpha);
+
+  Values value_{};  // Filtered value
+
+ public:
+  /**
+   * @brief Filter every channel
+   *
+   * @param sample New sample for each channel
+   * @return Values Filtered values
+   */
+  constexpr Values update(const Values& sample)
+  {
+    for (size_t i = 0; i < Channels; i++) { value_[i] += kAlpha * (sample[i] - value_[i]); }
+    return value_;
+  }
+
+  constexpr T update(T sample)
+    requires(Channels == 1)
+  {
+    return value_[0] += kAlpha * (sample - value_[0]);
+  }
+
+  constexpr void reset(T value = T(0)) { value_.fill(value); }
+};
+
+/**
+ * @brief Average of the last few samples (ThreeTapSMA is Taps = 3), starting from zeros
+ *
+ * @tparam T Scalar type
+ * @tparam Taps Samples averaged
+ * @tparam Channels Independent channels run together
+ */
+template <typename T, size_t Taps, size_t Channels = 1>
+class StaticMovingAverage
+{
+ public:
+  using Values = std::array<T, Channels>;
+
+ private:
+  static constexpr T kScale = T(1.0f / Taps);
+
+  std::array<Values, Taps> samples_{};  // Last samples, oldest at head_
+  size_t head_ = 0;                     // Slot the next sample goes in
+
+ public:
+  /**
+   * @brief Filter every channel
+   *
+   * @param sample New sample for each channel
+   * @return Values Averages
+   */
+  constexpr Values update(const Values& sample)
+  {
+    samples_[head_] = sample;
+    head_ = (head_ + 1) % Taps;
+
+    Values sum{};
+    for (const Values& tap : samples_)
+    {
+      for (size_t i = 0; i < Channels; i++) { sum[i] += tap[i]; }
+    }
+    for (size_t i = 0; i < Channels; i++) { sum[i] *= kScale; }
+    return sum;
+  }
+
+  constexpr T update(T sample)
+    requires(Channels == 1)
+  {
+    return this->update(Values{sample})[0];
+  }
+
+  constexpr void reset()
+  {
+    samples_ = {};
+    head_ = 0;
+  }
+};
+
+/**
+ * @brief VelocityController built from the pieces above: feedforward, PID on the error, slew
+ * and a dead band on the target that resets the loop
+ *
+ * @tparam T Scalar type
+ * @tparam Feedforward Feedforward gains
+ * @tparam Feedback PID gains
+ * @tparam Slew Output slew
+ * @tparam DeadBand Targets smaller than this output 0
+ * @tparam Channels Independent loops run together
+ */
+template <
+    typename T,
+    FeedforwardGains Feedforward,
+    PidGains Feedback,
+    SlewGains Slew,
+    float DeadBand,
+    size_t Channels = 1>
+class StaticVelocityController
+{
+ public:
+  using Values = std::array<T, Channels>;
+
+ private:
+  static constexpr T kDeadBand = T(DeadBand);
+
+  StaticPid<T, Feedback, Channels> feedback_;  // Feedback on the velocity error
+  StaticSlew<T, Slew, Channels> slew_;         // Output slew
+
+ public:
+  /**
+   * @brief Run every channel
+   *
+   * @param current Current velocity of each channel
+   * @param target Target velocity of each channel
+   * @return Values Outputs
+   */
+  constexpr Values update(const Values& current, const Values& target)
+  {
+    Values error;
+    for (size_t i = 0; i < Channels; i++) { error[i] = target[i] - current[i]; }
+
+    Values output = StaticFeedforward<T, Feedforward, Channels>::update(target, current);
+    Values feedback = feedback_.update(error);
+    for (size_t i = 0; i < Channels; i++) { output[i] += feedback[i]; }
+    output = slew_.update(output);
+
+    // Inside the dead band a channel rests, then slews up from 0 again
+    if constexpr (DeadBand != 0.0f)
+    {
+      for (size_t i = 0; i < Channels; i++)
+      {
+        if (controlAbs(target[i]) >= kDeadBand) { continue; }
+        feedback_.clearIntegral(i);
+        slew_.set(i, T(0));
+        output[i] = T(0);
+      }
+    }
+    return output;
+  }
+
+  constexpr T update(T current, T target)
+    requires(Channels == 1)
+  {
+    return this->update(Values{current}, Values{target})[0];
+  }
+
+  constexpr void reset()
+  {
+    feedback_.reset();
+    slew_.reset();
+  }
+};
@@ -0,0 +1,250 @@
+/**
+ * @file deferred_format.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Format strings registered at compile time so log arguments can be formatted later
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifndef FMT_HEADER_ONLY
+#define FMT_HEADER_ONLY
+#endif
+#include "fmt/args.h"
+#include "fmt/core.h"
+
+/**
+ * @brief String literal usable as a template argument
+ *
+ * @tparam N Length including the terminator
+ */
+template <size_t N>
+struct FixedString
+{
+  char data[N]{};
+
+  constexpr FixedString(const char (&text)[N])
+  {
+    for (size_t i = 0; i < N; i++) { data[i] = text[i]; }
+  }
+};
+
+template <typename T>
+inline constexpr bool kDeferredUnsupported = false;
+
+/**
+ * @brief Get the code an argument type is packed as
+ * @details b = bool, i/u = 32 bit int, l/L = 64 bit int, f = float, d = double
+ *
+ * @tparam T Argument type
+ * @return char Type code
+ */
+template <typename T>
+constexpr char deferredArgCode()
+{
+  using U = std::remove_cvref_t<T>;
+  if constexpr (std::is_same_v<U, bool>) { return 'b'; }
+  else if constexpr (std::is_enum_v<U>) { return deferredArgCode<std::underlying_type_t<U>>(); }
+  else if constexpr (std::is_floating_point_v<U>) { return sizeof(U) <= 4 ? 'f' : 'd'; }
+  else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+  {
+    return sizeof(U) <= 4 ? 'i' : 'l';
+  }
+  else if constexpr (std::is_integral_v<U>) { return sizeof(U) <= 4 ? 'u' : 'L'; }
+  else
+  {
+    static_assert(kDeferredUnsupported<U>, "Deferred log arguments must be numbers or bools");
+    return '\0';
+  }
+}
+
+/**
+ * @brief Get the packed size of an argument type code
+ *
+ * @param code Type code
+ * @return size_t Bytes
+ */
+constexpr size_t deferredArgSize(char code)
+{
+  switch (code)
+  {
+    case 'b': return 1;
+    case 'i':
+    case 'u':
+    case 'f': return 4;
+    case 'l':
+    case 'L':
+    case 'd': return 8;
+    default: return 0;
+  }
+}
+
+/**
+ * @brief Type codes of an argument list, as a null terminated string
+ *
+ * @tparam Args Argument types
+ */
+template <typename... Args>
+struct DeferredSignature
+{
+  static constexpr char value[] = {deferredArgCode<Args>()..., '\0'};
+  static constexpr size_t packed_size =
+      (size_t{0} + ... + deferredArgSize(deferredArgCode<Args>()));
+};
+
+/**
+ * @brief Pack one argument at its type code's size
+ *
+ * @param out Where to write, advanced past the argument
+ * @param value Argument
+ */
+template <typename T>
+void packDeferredArg(uint8_t*& out, const T& value)
+{
+  constexpr char code = deferredArgCode<T>();
+  auto write = [&out](auto stored) {
+    std::memcpy(out, &stored, sizeof(stored));
+    out += sizeof(stored);
+  };
+
+  if constexpr (code == 'b') { write(static_cast<uint8_t>(value)); }
+  else if constexpr (code == 'i') { write(static_cast<int32_t>(value)); }
+  else if constexpr (code == 'u') { write(static_cast<uint32_t>(value)); }
+  else if constexpr (code == 'l') { write(static_cast<int64_t>(value)); }
+  else if constexpr (code == 'L') { write(static_cast<uint64_t>(value)); }
+  else if constexpr (code == 'f') { write(static_cast<float>(value)); }
+  else { write(static_cast<double>(value)); }
+}
+
+struct DeferredFormat
+{
+  const char* format = nullptr;     // fmt style format string
+  const char* signature = nullptr;  // Argument type codes
+};
+
+/**
+ * @brief Table of every deferred format string in the program
+ * @details Formats add themselves during static initialisation, the table is constant initialised
+ * so it is always ready first.
+ *
+ */
+class DeferredFormatRegistry
+{
+ public:
+  static constexpr uint16_t kMaxFormats = 256;
+  static constexpr uint16_t kInvalid = 0xFFFF;
+
+ private:
+  std::array<DeferredFormat, kMaxFormats> formats_{};
+  std::atomic<uint16_t> count_{0};
+
+ public:
+  constexpr DeferredFormatRegistry() = default;
+
+  /**
+   * @brief Add a format to the table
+   *
+   * @param format Format string (must outlive the program, e.g. a literal)
+   * @param signature Argument type codes
+   * @return uint16_t Id of the format, kInvalid if the table is full
+   */
+  uint16_t add(const char* format, const char* signature)
+  {
+    uint16_t id = count_.fetch_add(1);
+    if (id >= kMaxFormats) { return kInvalid; }
+
+    formats_[id] = {format, signature};
+    return id;
+  }
+
+  /**
+   * @brief Look up a format
+   *
+   * @param id Id of the format
+   * @return const DeferredFormat* Format, nullptr if the id isn't registered
+   */
+  const DeferredFormat* get(uint16_t id) const
+  {
+    return id < this->size() ? &formats_[id] : nullptr;
+  }
+
+  uint16_t size() const { return std::min<uint16_t>(count_.load(), kMaxFormats); }
+};
+
+inline constinit DeferredFormatRegistry deferred_formats;
+
+/**
+ * @brief Id of a format string and argument list, assigned once at startup
+ *
+ * @tparam Format Format string
+ * @tparam Args Argument types
+ */
+template <FixedString Format, typename... Args>
+struct DeferredFormatId
+{
+  static inline const uint16_t value =
+      deferred_formats.add(Format.data, DeferredSignature<Args...>::value);
+};
+
+/**
+ * @brief Format packed arguments, on the drain task or on the host after decoding
+ *
+ * @param format Format string
+ * @param signature Argument type codes
+ * @param args Packed arguments
+ * @param args_size Bytes of packed arguments
+ * @param out Output buffer, always null terminated
+ * @param out_size Size of the output buffer
+ * @return size_t Characters written (not counting the terminator)
+ */
+inline size_t formatDeferred(
+    const char* format,
+    const char* signature,
+    const uint8_t* args,
+    size_t args_size,
+    char* out,
+    size_t out_size)
+{
+  if (out_size == 0) { return 0; }
+
+  fmt::dynamic_format_arg_store<fmt::format_context> store;
+  const uint8_t* end = args + args_size;
+
+  for (const char* code = signature; *code != '\0'; code++)
+  {
+    if (args + deferredArgSize(*code) > end) { break; }
+
+    auto read = [&args](auto stored) {
+      std::memcpy(&stored, args, sizeof(stored));
+      args += sizeof(stored);
+      return stored;
+    };
+
+    switch (*code)
+    {
+      case 'b': store.push_back(read(uint8_t{}) != 0); break;
+      case 'i': store.push_back(read(int32_t{})); break;
+      case 'u': store.push_back(read(uint32_t{})); break;
+      case 'l': store.push_back(read(int64_t{})); break;
+      case 'L': store.push_back(read(uint64_t{})); break;
+      case 'f': store.push_back(read(float{})); break;
+      case 'd': store.push_back(read(double{})); break;
+    }
+  }
+
+  auto result = fmt::vformat_to_n(out, out_size - 1, format, store);
+  *result.out = '\0';
+  return result.out - out;
+}
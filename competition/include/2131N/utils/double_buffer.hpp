@@ -0,0 +1,91 @@
+/**
+ * @file double_buffer.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Lock-free double buffer, one writer publishing snapshots to any number of readers
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Two copies of a value, readers copy the published one while the writer fills the other
+ * @details The writer never waits. If a reader is still copying the buffer the writer wants to
+ * fill, that snapshot is skipped and readers keep the previous one a little longer. Readers
+ * never wait on the writer either, they only retry if the buffer they picked was republished
+ * under them.
+ *
+ * @tparam T Snapshot type
+ */
+template <typename T>
+class DoubleBuffer
+{
+ private:
+  std::array<T, 2> buffers_{};                            // Snapshots
+  std::atomic<uint8_t> published_{0};                     // Buffer readers copy from
+  mutable std::array<std::atomic<uint32_t>, 2> readers_;  // Readers copying each buffer
+  bool writing_ = false;                                  // Writer has a buffer out
+
+ public:
+  DoubleBuffer()
+  {
+    for (auto& readers : readers_) { readers.store(0); }
+  }
+
+  /**
+   * @brief Get the buffer to fill (writer only), call publish() when done
+   *
+   * @return T* Unpublished buffer, nullptr if a reader still has it
+   */
+  T* beginWrite()
+  {
+    uint8_t next = published_.load() ^ 1;
+    if (readers_[next].load() != 0) { return nullptr; }
+
+    writing_ = true;
+    return &buffers_[next];
+  }
+
+  /**
+   * @brief Make the buffer from beginWrite() the one readers get
+   *
+   */
+  void publish()
+  {
+    if (!writing_) { return; }
+
+    writing_ = false;
+    published_.store(published_.load() ^ 1);
+  }
+
+  /**
+   * @brief Copy the latest published snapshot
+   *
+   * @param out Snapshot
+   */
+  void read(T& out) const
+  {
+    while (true)
+    {
+      uint8_t index = published_.load();
+      readers_[index].fetch_add(1);
+
+      // The writer may have picked this buffer before it saw us, if so try the new one
+      if (published_.load() == index)
+      {
+        out = buffers_[index];
+        readers_[index].fetch_sub(1);
+        return;
+      }
+
+      readers_[index].fetch_sub(1);
+    }
+  }
+};
@@ -0,0 +1,230 @@
+/**
+ * @file drive_curve.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Stick shaping for driver control, curves are baked into lookup tables at compile time
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+enum class CurveType : uint8_t
+{
+  LINEAR,    // Output follows the stick
+  EXPO,      // lemlib's expo curve, gain is the curvature
+  CUBIC,     // Blend of linear and cubed, gain is the cubed share (0 to 1)
+  PIECEWISE  // Straight lines between points
+};
+
+/**
+ * @brief Point on a piecewise curve, stick and output are 0 to 1 past the dead band
+ *
+ */
+struct CurvePoint
+{
+  float input;   // Stick
+  float output;  // Output
+};
+
+struct CurveSettings
+{
+  static constexpr size_t kMaxPoints = 4;
+
+  CurveType type = CurveType::LINEAR;  // Shape past the dead band
+  float dead_band = 0.0f;              // Stick below this reads 0 (-127 to 127 counts)
+  float gain = 0.0f;                   // Curvature (EXPO) or cubed share (CUBIC)
+  float scale = 1.0f;                  // Output at full stick (0 to 1)
+
+  // Points between (0, 0) and (1, 1) for PIECEWISE, in increasing input order
+  std::array<CurvePoint, kMaxPoints> points{};
+  size_t point_count = 0;  // Points in use
+};
+
+using DriveLut = std::array<int8_t, 256>;  // Output for every stick value, indexed by stick + 128
+
+/**
+ * @brief e^x that can run at compile time
+ *
+ * @param x Exponent
+ * @return float e^x
+ */
+constexpr float curveExp(float x)
+{
+  // Halve until the series converges fast, then square back up
+  int halvings = 0;
+  while (x > 0.5f || x < -0.5f)
+  {
+    x /= 2.0f;
+    halvings++;
+  }
+
+  float term = 1.0f;
+  float sum = 1.0f;
+  for (int i = 1; i < 10; i++)
+  {
+    term *= x / i;
+    sum += term;
+  }
+
+  for (; halvings > 0; halvings--) { sum *= sum; }
+  return sum;
+}
+
+/**
+ * @brief Shape a stick value past the dead band
+ *
+ * @param settings Curve
+ * @param t Stick (0 to 1)
+ * @return float Output (0 to 1)
+ */
+constexpr float shapeCurve(const CurveSettings& settings, float t)
+{
+  switch (settings.type)
+  {
+    case CurveType::LINEAR: return t;
+    case CurveType::EXPO:
+    {
+      // lemlib's ExpoDriveCurve with the stick taken as 0 to 1
+      float low = curveExp(-settings.gain / 10.0f);
+      return t * (low + curveExp(12.7f * (t - 1.0f)) * (1.0f - low));
+    }
+    case CurveType::CUBIC: return (1.0f - settings.gain) * t + settings.gain * t * t * t;
+    case CurveType::PIECEWISE:
+    {
+      CurvePoint previous = {0.0f, 0.0f};
+      for (size_t i = 0; i <= settings.point_count; i++)
+      {
+        CurvePoint next = i < settings.point_count ? settings.points[i] : CurvePoint{1.0f, 1.0f};
+        if (t <= next.input && next.input > previous.input)
+        {
+          float along = (t - previous.input) / (next.input - previous.input);
+          return previous.output + along * (next.output - previous.output);
+        }
+        previous = next;
+      }
+      return 1.0f;
+    }
+  }
+  return t;
+}
+
+/**
+ * @brief Bake a curve into a lookup table
+ * @details The dead band is smooth: the output starts from 0 at its edge and the rest of the
+ * stick is stretched to still reach full output, so there's no jump when the stick leaves it.
+ *
+ * @param settings Curve
+ * @return DriveLut Output (-127 to 127) for every stick value
+ */
+constexpr DriveLut makeDriveLut(const CurveSettings& settings)
+{
+  DriveLut lut{};
+  for (int i = 0; i < 256; i++)
+  {
+    // -128 never comes from a stick, treat it as -127
+    int stick = std::max(i - 128, -127);
+    float magnitude = stick < 0 ? -stick : stick;
+
+    float output = 0.0f;
+    if (magnitude > settings.dead_band)
+    {
+      float t = (magnitude - settings.dead_band) / (127.0f - settings.dead_band);
+      output = std::clamp(shapeCurve(settings, t), 0.0f, 1.0f) * settings.scale * 127.0f;
+    }
+
+    int rounded = static_cast<int>(output + 0.5f);
+    lut[i] = static_cast<int8_t>(stick < 0 ? -rounded : rounded);
+  }
+  return lut;
+}
+
+/**
+ * @brief How one driver likes the sticks
+ *
+ */
+struct DriverProfile
+{
+  const char* name;    // Shown on the screen
+  DriveLut normal;     // Stick to output
+  DriveLut precision;  // Stick to output while the precision button is held
+  float slew = 0.0f;   // Fastest an output can speed up (counts/s), 0 for no limit
+};
+
+/**
+ * @brief Move towards a target by at most a step, slowing down is never limited
+ * @details Letting go of the sticks has to stop the robot right away. Reversing drops to 0 at
+ * once and then speeds up from there.
+ *
+ * @param current Current output
+ * @param target Output wanted
+ * @param max_step Largest increase allowed, 0 or less for no limit
+ * @return float New output
+ */
+constexpr float slewTowards(float current, float target, float max_step)
+{
+  bool slowing = target * current >= 0.0f && std::abs(target) <= std::abs(current);
+  if (max_step <= 0.0f || slowing) { return target; }
+
+  float from = target * current < 0.0f ? 0.0f : current;
+  return from + std::clamp(target - from, -max_step, max_step);
+}
+
+/**
+ * @brief Turns the tank sticks into outputs with the selected driver's profile
+ *
+ */
+class DriveShaper
+{
+ private:
+  const DriverProfile* profile_;  // Selected profile
+  float left_ = 0.0f;             // Left output after the slew limit (counts)
+  float right_ = 0.0f;            // Right output after the slew limit (counts)
+
+ public:
+  explicit DriveShaper(const DriverProfile* profile) : profile_(profile) {}
+
+  /**
+   * @brief Change profile, the outputs speed up from 0 with the new one
+   *
+   * @param profile Profile (must outlive the shaper)
+   */
+  void setProfile(const DriverProfile* profile)
+  {
+    if (profile == profile_) { return; }
+
+    profile_ = profile;
+    left_ = 0.0f;
+    right_ = 0.0f;
+  }
+
+  const DriverProfile* getProfile() const { return profile_; }
+
+  /**
+   * @brief Shape the sticks
+   *
+   * @param left Left stick (-127 to 127)
+   * @param right Right stick (-127 to 127)
+   * @param precision Use the precision curve
+   * @param dT Time since the last call (ms)
+   * @return std::pair<float, float> Left and right output (-127 to 127)
+   */
+  std::pair<float, float> shape(int8_t left, int8_t right, bool precision, float dT)
+  {
+    const DriveLut& lut = precision ? profile_->precision : profile_->normal;
+    float max_step = profile_->slew * dT / 1000.0f;
+
+    left_ = slewTowards(left_, lut[left + 128], max_step);
+    right_ = slewTowards(right_, lut[right + 128], max_step);
+    return {left_, right_};
+  }
+};
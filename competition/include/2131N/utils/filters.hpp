@@ -13,7 +13,11 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+
+#include "2131N/utils/matrix.hpp"
 
 class RunningAverage
 {
@@ -31,78 +35,265 @@ class RunningAverage
   float filter(const float& new_error);
 };
 
+/**
+ * @brief Linear Kalman filter over NStates states from NMeas sensor readings
+ * @details All matrices are fixed size, nothing is allocated. Once the gain stops changing
+ * (it only depends on the model and noise, not the readings) the filter keeps that gain and
+ * skips the covariance math, so a settled filter is a couple of multiply-adds per state.
+ * Changing the noise starts the covariance updates again.
+ *
+ * @tparam NStates States estimated (value, velocity, acceleration...)
+ * @tparam NMeas Readings per update
+ */
+template <size_t NStates, size_t NMeas = 1>
 class KalmanFilter
 {
+ public:
+  using State = Matrix<NStates, 1>;
+  using Measurement = Matrix<NMeas, 1>;
+  using StateMatrix = Matrix<NStates, NStates>;
+  using ObservationMatrix = Matrix<NMeas, NStates>;
+  using NoiseMatrix = Matrix<NMeas, NMeas>;
+  using Gain = Matrix<NStates, NMeas>;
+
+  static constexpr float kSteadyTolerance = 1e-5f;  // Gain change counted as no change
+  static constexpr int kSteadyUpdates = 10;         // Unchanged updates before the gain is kept
+
  private:
-  float sensor_variance_;    // Variance of Sensor
-  float estimate_variance_;  // Variance of Guess
-  float kalman_gain_;
-  const float derivative_variance_;  // Variance of the derivative of the sensor
+  StateMatrix transition_;          // F, moves the state forward one update
+  StateMatrix process_noise_;       // Q, how far the model can be off each update
+  ObservationMatrix observation_;   // H, the readings each state gives
+  NoiseMatrix measurement_noise_;   // R, sensor variance
+  StateMatrix initial_covariance_;  // Covariance after a reset
 
-  float estimate_value_;  // Estimated Reality
+  State estimate_;          // Estimated Reality
+  StateMatrix covariance_;  // P, variance of the estimate
+  Gain gain_;               // K, share of each reading taken
 
-  float last_sensor_value_ = 0.0f;       // Previous Loop Value
-  float last_sensor_derivative_ = 0.0f;  // Previous Loop Change
-  float last_guess_ = 0.0f;              // Last output from filter
-  const float kPN_;                      // Random Noise
+  int settled_updates_ = 0;  // Updates in a row the gain hasn't changed
+  bool steady_ = false;      // Gain is fixed, covariance isn't updated
 
  public:
   /**
    * @brief Construct a new Kalman Filter
    *
+   * @param transition F, state after one update from the state now
+   * @param process_noise Q, variance the model adds each update
+   * @param observation H, readings from the state
+   * @param measurement_noise R, sensor variance
+   * @param initial_covariance Variance of the starting estimate (0s)
+   */
+  constexpr KalmanFilter(
+      const StateMatrix& transition,
+      const StateMatrix& process_noise,
+      const ObservationMatrix& observation,
+      const NoiseMatrix& measurement_noise,
+      const StateMatrix& initial_covariance = StateMatrix::identity())
+      : transition_(transition),
+        process_noise_(process_noise),
+        observation_(observation),
+        measurement_noise_(measurement_noise),
+        initial_covariance_(initial_covariance),
+        covariance_(initial_covariance)
+  {
+  }
+
+  /**
+   * @brief Filter holding one value that drifts at random (what the old scalar filter did)
+   *
+   * @param process_noise Variance the value drifts each update
    * @param sensor_variance Sensor Variance
-   * @param estimate_variance Model Variance
-   * @param derivative_variance Derivative of Sensor Variance
-   * @param k_process_noise Tunning value for adding process noise
+   * @return KalmanFilter Filter
    */
-  KalmanFilter(
-      float sensor_variance,
-      float estimate_variance,
-      float derivative_variance,
-      float k_process_noise);
+  static constexpr KalmanFilter randomWalk(float process_noise, float sensor_variance)
+    requires(NStates == 1 && NMeas == 1)
+  {
+    return KalmanFilter(
+        StateMatrix::identity(),
+        StateMatrix{{process_noise}},
+        ObservationMatrix{{1.0f}},
+        NoiseMatrix{{sensor_variance}},
+        StateMatrix{{sensor_variance}});
+  }
 
   /**
-   * @brief Set the Sensor Variance
+   * @brief Filter for a value and its velocity, from readings of the value
    *
-   * @param new_variance
+   * @param dT Time between updates, the velocity comes out per this unit
+   * @param accel_variance Variance of the acceleration between updates
+   * @param sensor_variance Sensor Variance
+   * @return KalmanFilter Filter
    */
-  void setSensorVariance(const float& new_variance);
+  static constexpr KalmanFilter constantVelocity(
+      float dT, float accel_variance, float sensor_variance)
+    requires(NStates == 2 && NMeas == 1)
+  {
+    return fromKinematics(
+        StateMatrix{{1.0f, dT, 0.0f, 1.0f}},
+        State{{dT * dT / 2.0f, dT}},
+        accel_variance,
+        sensor_variance);
+  }
 
   /**
-   * @brief Filter a value
+   * @brief Filter for a value, its velocity and its acceleration, from readings of the value
    *
-   * @param measured_value Sensor reading
-   * @param delta_time Time elapsed since last reading
-   * @return float filtered value
+   * @param dT Time between updates, the velocity comes out per this unit
+   * @param jerk_variance Variance of the change in acceleration between updates
+   * @param sensor_variance Sensor Variance
+   * @return KalmanFilter Filter
+   */
+  static constexpr KalmanFilter constantAcceleration(
+      float dT, float jerk_variance, float sensor_variance)
+    requires(NStates == 3 && NMeas == 1)
+  {
+    return fromKinematics(
+        StateMatrix{{1.0f, dT, dT * dT / 2.0f, 0.0f, 1.0f, dT, 0.0f, 0.0f, 1.0f}},
+        State{{dT * dT / 2.0f, dT, 1.0f}},
+        jerk_variance,
+        sensor_variance);
+  }
+
+  /**
+   * @brief Move the estimate forward one update with the model
+   *
+   */
+  constexpr void predict()
+  {
+    estimate_ = transition_ * estimate_;
+    if (steady_) { return; }
+    covariance_ = transition_ * covariance_ * transition_.transpose() + process_noise_;
+  }
+
+  /**
+   * @brief Correct the estimate with a reading
+   *
+   * @param measurement Sensor readings
    */
-  float filter(const float& measured_value, const float& delta_time);
+  constexpr void update(const Measurement& measurement)
+  {
+    if (!steady_)
+    {
+      NoiseMatrix innovation_variance =
+          observation_ * covariance_ * observation_.transpose() + measurement_noise_;
+      NoiseMatrix inverse;
+      if (!invert(innovation_variance, inverse)) { return; }
+
+      Gain gain = covariance_ * observation_.transpose() * inverse;
+      covariance_ = (StateMatrix::identity() - gain * observation_) * covariance_;
+
+      // Once the gain settles it would come out the same every update
+      float change = 0.0f;
+      for (size_t i = 0; i < gain.data.size(); i++)
+      {
+        change = std::max(change, std::abs(gain.data[i] - gain_.data[i]));
+      }
+      settled_updates_ = change < kSteadyTolerance ? settled_updates_ + 1 : 0;
+      steady_ = settled_updates_ >= kSteadyUpdates;
+      gain_ = gain;
+    }
+
+    estimate_ = estimate_ + gain_ * (measurement - observation_ * estimate_);
+  }
 
   /**
-   * @brief Get the Estimate Variance
+   * @brief Predict then update with a reading
+   *
+   * @param measurement Sensor readings
+   * @return State Estimate
+   */
+  constexpr const State& filter(const Measurement& measurement)
+  {
+    this->predict();
+    this->update(measurement);
+    return estimate_;
+  }
+
+  /**
+   * @brief Filter a value
    *
-   * @return float Estimated Variance
+   * @param measured_value Sensor reading
+   * @return float Estimate of the first state
    */
-  float getEstimateVariance();
+  constexpr float filter(float measured_value)
+    requires(NMeas == 1)
+  {
+    return this->filter(Measurement{{measured_value}})(0, 0);
+  }
+
   /**
-   * @brief Get the Sensor Variance
+   * @brief Start again from an estimate, with the initial covariance
    *
-   * @return float Sensor Variance
+   * @param estimate Starting estimate
    */
-  float getSensorVariance();
+  constexpr void reset(const State& estimate = {})
+  {
+    estimate_ = estimate;
+    covariance_ = initial_covariance_;
+    this->restartGain();
+  }
+
+  constexpr void setProcessNoise(const StateMatrix& process_noise)
+  {
+    process_noise_ = process_noise;
+    this->restartGain();
+  }
+
+  constexpr void setMeasurementNoise(const NoiseMatrix& measurement_noise)
+  {
+    measurement_noise_ = measurement_noise;
+    this->restartGain();
+  }
 
   /**
-   * @brief Get the current Kalman Gain value
+   * @brief Set the Sensor Variance
    *
-   * @return float Kalman Gain (0-1)
+   * @param sensor_variance Sensor Variance
    */
-  float getKalmanGain();
+  constexpr void setSensorVariance(float sensor_variance)
+    requires(NMeas == 1)
+  {
+    this->setMeasurementNoise(NoiseMatrix{{sensor_variance}});
+  }
 
+  constexpr const State& getEstimate() const { return estimate_; }
+  constexpr float getValue() const { return estimate_(0, 0); }
+  constexpr const StateMatrix& getCovariance() const { return covariance_; }
+  constexpr const Gain& getGain() const { return gain_; }
+  constexpr bool isSteady() const { return steady_; }
+
+ private:
   /**
-   * @brief Get the Estimated Value
+   * @brief Filter over a kinematic chain driven by noise on its last state
    *
-   * @return float Estimated Value
+   * @param transition F
+   * @param noise_gain How a unit of noise on the last state moves each state over one update
+   * @param noise_variance Variance of the noise
+   * @param sensor_variance Sensor Variance
+   * @return KalmanFilter Filter
    */
-  float getEstimate();
+  static constexpr KalmanFilter fromKinematics(
+      const StateMatrix& transition,
+      const State& noise_gain,
+      float noise_variance,
+      float sensor_variance)
+  {
+    ObservationMatrix observation;
+    observation(0, 0) = 1.0f;
+
+    return KalmanFilter(
+        transition,
+        noise_gain * noise_gain.transpose() * noise_variance,
+        observation,
+        NoiseMatrix{{sensor_variance}},
+        StateMatrix::identity() * sensor_variance);
+  }
+
+  constexpr void restartGain()
+  {
+    settled_updates_ = 0;
+    steady_ = false;
+  }
 };
 
 class ThreeTapSMA
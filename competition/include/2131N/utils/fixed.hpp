@@ -0,0 +1,108 @@
+/**
+ * @file fixed.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Q16.16 fixed point number that can stand in for float in the control templates
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <compare>
+#include <cstdint>
+
+/**
+ * @brief Signed Q16.16 fixed point, 16 integer bits and 16 fraction bits
+ * @details Covers +-32767.99998 with a step of 1/65536, enough for mV, rpm and in/s. Products
+ * and quotients go through 64 bits so they only round in the last bit. Every conversion and
+ * operation saturates at the ends of the range (NaN becomes 0, dividing by 0 gives the end with
+ * the dividend's sign), so nothing overflows into undefined behaviour. The range is symmetric,
+ * so negating is always safe too.
+ *
+ */
+struct Fixed
+{
+  static constexpr int kFractionBits = 16;
+  static constexpr int32_t kOne = 1 << kFractionBits;
+  static constexpr int32_t kMaxRaw = INT32_MAX;  // Largest raw value, the smallest is -kMaxRaw
+
+  int32_t raw = 0;  // Value * 65536
+
+  constexpr Fixed() = default;
+  constexpr Fixed(int value) : raw(saturate(static_cast<int64_t>(value) * kOne)) {}
+  constexpr Fixed(float value) : raw(round(static_cast<double>(value) * kOne)) {}
+  constexpr Fixed(double value) : raw(round(value * kOne)) {}
+
+  /**
+   * @brief Make a fixed point number from its raw bits
+   *
+   * @param raw Value * 65536
+   * @return Fixed Number
+   */
+  static constexpr Fixed fromRaw(int32_t raw)
+  {
+    Fixed fixed;
+    fixed.raw = raw;
+    return fixed;
+  }
+
+  constexpr explicit operator float() const { return static_cast<float>(raw) / kOne; }
+  constexpr explicit operator double() const { return static_cast<double>(raw) / kOne; }
+
+  constexpr Fixed operator-() const { return fromRaw(-raw); }
+  constexpr Fixed operator+(Fixed other) const
+  {
+    return fromRaw(saturate(static_cast<int64_t>(raw) + other.raw));
+  }
+  constexpr Fixed operator-(Fixed other) const
+  {
+    return fromRaw(saturate(static_cast<int64_t>(raw) - other.raw));
+  }
+  constexpr Fixed operator*(Fixed other) const
+  {
+    return fromRaw(saturate((static_cast<int64_t>(raw) * other.raw) >> kFractionBits));
+  }
+  constexpr Fixed operator/(Fixed other) const
+  {
+    if (other.raw == 0) { return fromRaw(raw < 0 ? -kMaxRaw : raw > 0 ? kMaxRaw : 0); }
+    return fromRaw(saturate((static_cast<int64_t>(raw) << kFractionBits) / other.raw));
+  }
+
+  constexpr Fixed& operator+=(Fixed other) { return *this = *this + other; }
+  constexpr Fixed& operator-=(Fixed other) { return *this = *this - other; }
+  constexpr Fixed& operator*=(Fixed other) { return *this = *this * other; }
+  constexpr Fixed& operator/=(Fixed other) { return *this = *this / other; }
+
+  constexpr auto operator<=>(const Fixed&) const = default;
+
+ private:
+  /**
+   * @brief Clamp a wide raw value into the range
+   *
+   * @param value Raw value, 64 bit
+   * @return int32_t Raw value
+   */
+  static constexpr int32_t saturate(int64_t value)
+  {
+    if (value > kMaxRaw) { return kMaxRaw; }
+    if (value < -kMaxRaw) { return -kMaxRaw; }
+    return static_cast<int32_t>(value);
+  }
+
+  /**
+   * @brief Round a scaled value to the nearest raw value, clamping before the conversion
+   *
+   * @param scaled Value * 65536
+   * @return int32_t Raw value
+   */
+  static constexpr int32_t round(double scaled)
+  {
+    if (scaled != scaled) { return 0; }  // NaN
+    if (scaled >= kMaxRaw) { return kMaxRaw; }
+    if (scaled <= -kMaxRaw) { return -kMaxRaw; }
+    return static_cast<int32_t>(scaled + (scaled < 0 ? -0.5 : 0.5));
+  }
+};
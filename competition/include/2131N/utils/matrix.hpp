@@ -0,0 +1,151 @@
+/**
+ * @file matrix.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Small fixed size float matrices, no heap
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief Rows x Cols float matrix stored row by row
+ * @details Meant for the handful of states a filter on the brain has, everything is plain loops
+ * the compiler can unroll.
+ *
+ * @tparam Rows Rows
+ * @tparam Cols Columns
+ */
+template <size_t Rows, size_t Cols>
+struct Matrix
+{
+  std::array<float, Rows * Cols> data{};  // Elements, row by row
+
+  constexpr float& operator()(size_t row, size_t col) { return data[row * Cols + col]; }
+  constexpr float operator()(size_t row, size_t col) const { return data[row * Cols + col]; }
+
+  static constexpr Matrix identity()
+    requires(Rows == Cols)
+  {
+    Matrix matrix;
+    for (size_t i = 0; i < Rows; i++) { matrix(i, i) = 1.0f; }
+    return matrix;
+  }
+
+  constexpr Matrix<Cols, Rows> transpose() const
+  {
+    Matrix<Cols, Rows> result;
+    for (size_t r = 0; r < Rows; r++)
+    {
+      for (size_t c = 0; c < Cols; c++) { result(c, r) = (*this)(r, c); }
+    }
+    return result;
+  }
+
+  constexpr Matrix operator+(const Matrix& other) const
+  {
+    Matrix result;
+    for (size_t i = 0; i < data.size(); i++) { result.data[i] = data[i] + other.data[i]; }
+    return result;
+  }
+
+  constexpr Matrix operator-(const Matrix& other) const
+  {
+    Matrix result;
+    for (size_t i = 0; i < data.size(); i++) { result.data[i] = data[i] - other.data[i]; }
+    return result;
+  }
+
+  constexpr Matrix operator*(float scale) const
+  {
+    Matrix result;
+    for (size_t i = 0; i < data.size(); i++) { result.data[i] = data[i] * scale; }
+    return result;
+  }
+
+  template <size_t Other>
+  constexpr Matrix<Rows, Other> operator*(const Matrix<Cols, Other>& other) const
+  {
+    Matrix<Rows, Other> result;
+    for (size_t r = 0; r < Rows; r++)
+    {
+      for (size_t c = 0; c < Other; c++)
+      {
+        float sum = 0.0f;
+        for (size_t k = 0; k < Cols; k++) { sum += (*this)(r, k) * other(k, c); }
+        result(r, c) = sum;
+      }
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief Invert a square matrix (Gauss-Jordan with partial pivoting)
+ *
+ * @tparam N Size
+ * @param matrix Matrix to invert
+ * @param inverse Inverse, left alone if there isn't one
+ * @return true Inverted
+ * @return false The matrix is singular
+ */
+template <size_t N>
+constexpr bool invert(const Matrix<N, N>& matrix, Matrix<N, N>& inverse)
+{
+  if constexpr (N == 1)
+  {
+    if (matrix(0, 0) == 0.0f) { return false; }
+    inverse(0, 0) = 1.0f / matrix(0, 0);
+    return true;
+  }
+  else
+  {
+    Matrix<N, N> left = matrix;
+    Matrix<N, N> right = Matrix<N, N>::identity();
+
+    for (size_t col = 0; col < N; col++)
+    {
+      size_t pivot = col;
+      for (size_t row = col + 1; row < N; row++)
+      {
+        if (std::abs(left(row, col)) > std::abs(left(pivot, col))) { pivot = row; }
+      }
+      if (left(pivot, col) == 0.0f) { return false; }
+
+      for (size_t c = 0; c < N; c++)
+      {
+        std::swap(left(col, c), left(pivot, c));
+        std::swap(right(col, c), right(pivot, c));
+      }
+
+      float scale = 1.0f / left(col, col);
+      for (size_t c = 0; c < N; c++)
+      {
+        left(col, c) *= scale;
+        right(col, c) *= scale;
+      }
+
+      for (size_t row = 0; row < N; row++)
+      {
+        if (row == col) { continue; }
+        float factor = left(row, col);
+        for (size_t c = 0; c < N; c++)
+        {
+          left(row, c) -= factor * left(col, c);
+          right(row, c) -= factor * right(col, c);
+        }
+      }
+    }
+
+    inverse = right;
+    return true;
+  }
+}
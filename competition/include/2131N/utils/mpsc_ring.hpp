@@ -0,0 +1,113 @@
+/**
+ * @file mpsc_ring.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Lock-free multiple producer, single consumer ring buffer
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed capacity ring any number of tasks can add to, emptied by one consumer task
+ * @details Each slot carries a sequence number, so producers claim a slot with a single
+ * compare-exchange and publish it by bumping the sequence. Full rings drop (and count) new items.
+ *
+ * @tparam T Item type (copied in and out)
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class MpscRing
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+ private:
+  struct Slot
+  {
+    std::atomic<uint32_t> sequence;  // Equals the position when free, position + 1 when filled
+    T item;                          // Stored item
+  };
+
+  std::array<Slot, Capacity> slots_;  // Item storage
+  std::atomic<uint32_t> head_{0};     // Next position to claim (shared by the producers)
+  uint32_t tail_ = 0;                 // Next position to read (consumer only)
+  std::atomic<uint32_t> dropped_{0};  // Items lost to a full ring
+
+ public:
+  MpscRing()
+  {
+    for (size_t i = 0; i < Capacity; i++)
+    {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Add an item (any task)
+   *
+   * @param item Item to add
+   * @return true The item was added
+   * @return false The ring was full and the item was dropped
+   */
+  bool push(const T& item)
+  {
+    uint32_t position = head_.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    while (true)
+    {
+      slot = &slots_[position & (Capacity - 1)];
+      int32_t lag = static_cast<int32_t>(slot->sequence.load(std::memory_order_acquire) - position);
+
+      if (lag == 0)
+      {
+        // Slot is free, try to claim it (position is refreshed if another task got there first)
+        if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (lag < 0)
+      {
+        // Slot still holds an item from a lap ago
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      else { position = head_.load(std::memory_order_relaxed); }
+    }
+
+    slot->item = item;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Take the oldest item (consumer only)
+   *
+   * @param item Set to the oldest item
+   * @return true An item was taken
+   * @return false The ring was empty (or the oldest item is still being written)
+   */
+  bool pop(T& item)
+  {
+    Slot& slot = slots_[tail_ & (Capacity - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1) { return false; }
+
+    item = slot.item;
+    slot.sequence.store(tail_ + Capacity, std::memory_order_release);
+    tail_++;
+    return true;
+  }
+
+  uint32_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  static constexpr size_t capacity() { return Capacity; }
+};
@@ -0,0 +1,93 @@
+/**
+ * @file settle_detector.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Velocity-aware exit condition with a settle predictor
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+struct SettleSettings
+{
+  float tolerance;       // Final error that counts as "on target" (in or deg)
+  float max_velocity;    // Chassis speed below which the robot counts as stopped (in/s or deg/s)
+  float max_error_rate;  // Error rate below which the error counts as steady (in/s or deg/s)
+  float deceleration;    // Expected braking deceleration, used to project the final error
+  uint32_t settle_time;  // Time the conditions have to hold before exiting (ms)
+};
+
+class SettleDetector
+{
+ private:
+  SettleSettings settings_;  // Exit Thresholds
+
+  float previous_error_ = 0.0f;   // Error on the last update (for the error rate)
+  float error_rate_ = 0.0f;       // Smoothed change in error (per second)
+  float projected_error_ = 0.0f;  // Where the error will end up once the robot stops
+  float settled_time_ = 0.0f;     // How long the exit conditions have held (ms)
+  bool first_update_ = true;      // No previous error yet
+  bool settled_ = false;          // Have the exit conditions been met
+  bool project_ = true;           // May exit on the projected error while closing
+
+ public:
+  /**
+   * @brief Construct a new Settle Detector
+   *
+   * @param settings Exit thresholds
+   */
+  SettleDetector(SettleSettings settings);
+
+  /**
+   * @brief Update the detector with the newest error and chassis velocity
+   *
+   * @param error Signed error to the target (in or deg)
+   * @param velocity Current chassis speed (in/s or deg/s)
+   * @param dT Time step in milliseconds (default is 10ms)
+   * @return true The motion has settled (or will settle within tolerance)
+   * @return false The motion still has to run
+   */
+  bool update(float error, float velocity, float dT = 10.0f);
+
+  /**
+   * @brief Allow or stop exits on the projected error
+   * @details The projection assumes the robot brakes at the set deceleration once the motion
+   * ends, which only holds with the drive in brake or hold mode.
+   *
+   * @param enabled Exit while closing once braking would stop within tolerance
+   */
+  void setProjection(bool enabled);
+
+  /**
+   * @brief Get the error the robot will end with if it brakes now
+   *
+   * @return float Projected final error magnitude
+   */
+  float getProjectedError() const;
+
+  /**
+   * @brief Get the smoothed rate of change of the error
+   *
+   * @return float Error rate (per second)
+   */
+  float getErrorRate() const;
+
+  /**
+   * @brief Get whether the last update met the exit conditions
+   *
+   * @return true Settled
+   * @return false Not settled
+   */
+  bool getSettled() const;
+
+  /**
+   * @brief Reset the detector for a new motion
+   *
+   */
+  void reset();
+};
@@ -0,0 +1,90 @@
+/**
+ * @file spsc_ring.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Lock-free single producer, single consumer ring buffer
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed capacity ring shared by exactly one producer task and one consumer task
+ * @details Neither side ever blocks or allocates. When the ring is full new items are dropped
+ * (and counted) so the producer's timing is never affected by a slow consumer.
+ *
+ * @tparam T Item type (copied in and out)
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SpscRing
+{
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+ private:
+  std::array<T, Capacity> items_{};    // Item storage
+  std::atomic<uint32_t> head_{0};      // Next slot to write (only the producer moves it)
+  std::atomic<uint32_t> tail_{0};      // Next slot to read (only the consumer moves it)
+  std::atomic<uint32_t> dropped_{0};   // Items lost to a full ring
+
+ public:
+  /**
+   * @brief Add an item (producer only)
+   *
+   * @param item Item to add
+   * @return true The item was added
+   * @return false The ring was full and the item was dropped
+   */
+  bool push(const T& item)
+  {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= Capacity)
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    items_[head & (Capacity - 1)] = item;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Take the oldest item (consumer only)
+   *
+   * @param item Set to the oldest item
+   * @return true An item was taken
+   * @return false The ring was empty
+   */
+  bool pop(T& item)
+  {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) { return false; }
+
+    item = items_[tail & (Capacity - 1)];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Get the number of items waiting (approximate while the other side is running)
+   *
+   * @return size_t Items in the ring
+   */
+  size_t size() const
+  {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  uint32_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  static constexpr size_t capacity() { return Capacity; }
+};
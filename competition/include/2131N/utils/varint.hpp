@@ -0,0 +1,88 @@
+/**
+ * @file varint.hpp
+ * @author Andrew Hilton (2131N)
+ * @brief Variable length integers, small values take fewer bytes
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t kVarintMaxSize = 5;  // Bytes in the longest 32 bit varint
+
+/**
+ * @brief Map signed values to unsigned ones so small magnitudes stay small (0,-1,1,-2 -> 0,1,2,3)
+ *
+ * @param value Signed value
+ * @return constexpr uint32_t Zigzag encoded value
+ */
+constexpr uint32_t zigzagEncode(int32_t value)
+{
+  return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+/**
+ * @brief Undo zigzagEncode
+ *
+ * @param value Zigzag encoded value
+ * @return constexpr int32_t Signed value
+ */
+constexpr int32_t zigzagDecode(uint32_t value)
+{
+  return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+/**
+ * @brief Write 7 bits per byte, low bits first, the top bit set on every byte but the last
+ *
+ * @param out Output, advanced past the varint (kVarintMaxSize bytes of space)
+ * @param value Value to write
+ */
+inline void putVarint(uint8_t*& out, uint32_t value)
+{
+  while (value >= 0x80)
+  {
+    *out++ = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  *out++ = static_cast<uint8_t>(value);
+}
+
+/**
+ * @brief Read a varint
+ *
+ * @param in Input, advanced past the varint
+ * @param end End of the input
+ * @param value Value read
+ * @return true Read a whole varint
+ * @return false Ran off the end of the input or the varint is too long
+ */
+inline bool getVarint(const uint8_t*& in, const uint8_t* end, uint32_t& value)
+{
+  value = 0;
+  for (size_t shift = 0; shift < 7 * kVarintMaxSize; shift += 7)
+  {
+    if (in == end) { return false; }
+
+    uint8_t byte = *in++;
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) { return true; }
+  }
+  return false;
+}
+
+inline void putSignedVarint(uint8_t*& out, int32_t value) { putVarint(out, zigzagEncode(value)); }
+
+inline bool getSignedVarint(const uint8_t*& in, const uint8_t* end, int32_t& value)
+{
+  uint32_t raw;
+  if (!getVarint(in, end, raw)) { return false; }
+  value = zigzagDecode(raw);
+  return true;
+}
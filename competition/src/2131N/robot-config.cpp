@@ -5,6 +5,7 @@
 #include "pros/misc.h"
 #include "pros/motor_group.hpp"
 #include "systems/chassis.hpp"
+#include "systems/mcl/sensor_mounts.hpp"
 
 pros::MotorGroup left_motors({-10, -9, -8}, pros::v5::MotorGears::blue, pros::v5::MotorUnits::deg);
 pros::MotorGroup right_motors({7, 6, 5}, pros::v5::MotorGears::blue, pros::v5::MotorUnits::deg);
@@ -24,6 +25,21 @@ pros::adi::Pneumatics middle_lift('E', false);
 pros::adi::Pneumatics storage_block('G', false);
 
 pros::Controller primary(pros::E_CONTROLLER_MASTER);
+ControllerInput controller_input(&primary);
+
+// driver profiles, picked on the screen (the curves are built into tables at compile time)
+constexpr std::array<DriverProfile, 3> driver_profiles = {{
+    {"Linear",
+     makeDriveLut({.dead_band = 17}),
+     makeDriveLut({.dead_band = 17, .scale = 0.5f})},
+    {"Expo",
+     makeDriveLut({.type = CurveType::EXPO, .dead_band = 5, .gain = 5.0f}),
+     makeDriveLut({.type = CurveType::EXPO, .dead_band = 5, .gain = 5.0f, .scale = 0.5f})},
+    {"Smooth",
+     makeDriveLut({.type = CurveType::CUBIC, .dead_band = 8, .gain = 0.6f}),
+     makeDriveLut({.type = CurveType::CUBIC, .dead_band = 8, .gain = 0.6f, .scale = 0.5f}),
+     1270.0f},  // full speed in 100ms
+}};
 
 lemlib::OdomSensors sensors{
     nullptr,
@@ -60,7 +76,86 @@ lemlib::ControllerSettings angular_controller(
     0      // maximum acceleration (slew)
 );
 
-Chassis chassis({drivetrain, lateral_controller, angular_controller, sensors});
+// lateral settle exit (ends moveToPoint / moveToPose once braking will stop on target)
+SettleSettings lateral_settle{
+    0.75,  // tolerance, in inches
+    2.0,   // max chassis speed, in inches per second
+    3.0,   // max error rate, in inches per second
+    60.0,  // braking deceleration, in inches per second squared
+    20     // settle time, in milliseconds
+};
+
+// angular settle exit (ends turns once braking will stop on target)
+SettleSettings angular_settle{
+    1.5,    // tolerance, in degrees
+    15.0,   // max chassis turn rate, in degrees per second
+    20.0,   // max error rate, in degrees per second
+    600.0,  // braking deceleration, in degrees per second squared
+    20      // settle time, in milliseconds
+};
+
+// drivetrain model for pose prediction
+PredictorSettings predictor_settings{
+    450.0 / 60.0 * M_PI * 3.21,  // wheel speed at 12V, in inches per second
+    11.875,                      // track width, in inches
+    0.12,                        // drive time constant, in seconds
+    120.0,                       // braking deceleration, in inches per second squared
+    1.0,                         // predicted stop tolerance, in inches
+    2.0                          // predicted stop tolerance, in degrees
+};
+
+// inner velocity loop for each drive side (inches per second in, millivolts out)
+VelocityController drive_velocity(
+    600.0,                                   // static gain (kS), in millivolts
+    12000.0 / (450.0 / 60.0 * M_PI * 3.21),  // velocity gain (kV), millivolts per inch per second
+    0.0,                                     // acceleration gain (kA)
+    40.0,                                    // proportional gain (kP)
+    0.0,                                     // integral gain (kI)
+    0.0,                                     // derivative gain (kD)
+    0.0,                                     // slew rate, in millivolts per second (0 = off)
+    0.0,                                     // integral windup
+    0.5                                      // dead band, in inches per second
+);
+
+// traction control for the drive velocity loop (driver control only). Kept loose until the
+// IMU axis is tuned: it only trims obvious wheel spin and never limits below 200 in/s^2
+TractionSettings traction_settings{
+    400.0,   // fastest side speed-up (tipping limit), in inches per second squared
+    200.0,   // slowest it backs off to while slipping, in inches per second squared
+    150.0,   // wheel and IMU acceleration gap that counts as slip, in inches per second squared
+    0.8,     // limit multiplier for every update that slips
+    1000.0,  // limit recovery while gripping, in inches per second squared per second
+    0.3,     // acceleration filter (1 = unfiltered)
+    11.875,  // track width, in inches
+    1.0,     // IMU x axis share of forward
+    0.0      // IMU y axis share of forward
+};
+
+Chassis chassis(
+    drivetrain,
+    lateral_controller,
+    angular_controller,
+    sensors,
+    lateral_settle,
+    angular_settle,
+    predictor_settings,
+    drive_velocity,
+    traction_settings);
+
+Scheduler scheduler;
+
+// velocity loop for each intake stage (rpm in, millivolts out), stages report in 200 rpm units
+VelocityController intake_velocity(
+    500.0,            // static gain (kS), in millivolts
+    12000.0 / 200.0,  // velocity gain (kV), millivolts per rpm
+    0.0,              // acceleration gain (kA)
+    30.0,             // proportional gain (kP)
+    0.0,              // integral gain (kI)
+    0.0,              // derivative gain (kD)
+    0.0,              // slew rate, in millivolts per second (0 = off)
+    0.0,              // integral windup
+    5.0               // dead band, in rpm
+);
 
 Intake intake(
     &firstStage,
@@ -69,21 +164,47 @@ Intake intake(
     &btmStorageDetector,
     &middle_descore,
     110.0f,
-    &primary,
     pros::E_CONTROLLER_DIGITAL_L2,
     pros::E_CONTROLLER_DIGITAL_L1,
     pros::E_CONTROLLER_DIGITAL_R1,
-    pros::E_CONTROLLER_DIGITAL_R2);
+    pros::E_CONTROLLER_DIGITAL_R2,
+    intake_velocity);
+
+TriggerEngine triggers(&chassis, &intake);
 
 Screen screen;
 
-DistanceSensor left_distance({-1.5, 6.25}, -M_PI_2, 20);
-DistanceSensor right_distance({-2.75, -6}, M_PI_2, 1);
-DistanceSensor back_distance({4.75, -2.25}, M_PI, 15);
-DistanceSensor front_distance({-6, -4.5}, 0, 18, 40);
+DistanceSensor left_distance(kLeftDistanceMount.offset, kLeftDistanceMount.heading, 20);
+DistanceSensor right_distance(kRightDistanceMount.offset, kRightDistanceMount.heading, 1);
+DistanceSensor back_distance(kBackDistanceMount.offset, kBackDistanceMount.heading, 15);
+DistanceSensor front_distance(kFrontDistanceMount.offset, kFrontDistanceMount.heading, 18, 40);
 
 Mcl<800> mcl_localization(
     &chassis,
     std::make_shared<Field>(Field(Point(1, 1), Point(143, 143))),
     std::vector<DistanceSensor*>{&left_distance, &back_distance, &right_distance, &front_distance});
 
+MatchRecorder match_recorder(
+    &chassis,
+    &intake,
+    {&left_distance, &back_distance, &right_distance, &front_distance},
+    {&left_motors, &right_motors, &firstStage, &secondStage, &thirdStage},
+    []() -> MclSample {
+      Point estimate = mcl_localization.get_point_estimate();
+      return {
+          static_cast<float>(estimate.x),
+          static_cast<float>(estimate.y),
+          static_cast<float>(mcl_localization.get_variance_estimate())};
+    });
+
+SerialTelemetry serial_telemetry(&chassis, [](SerialParticleCloud& cloud) {
+  MclSnapshot snapshot;
+  mcl_localization.get_snapshot(snapshot);
+  cloud.estimate = snapshot.estimate;
+  cloud.variance = snapshot.variance;
+  cloud.count = std::min(snapshot.count, cloud.particles.size());
+  std::copy_n(snapshot.particles.begin(), cloud.count, cloud.particles.begin());
+});
+
+FieldView field_view(
+    &chassis, &screen, [](MclSnapshot& snapshot) { mcl_localization.get_snapshot(snapshot); });
@@ -1,11 +1,230 @@
 #include "2131N/systems/chassis.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include "2131N/systems/telemetry.hpp"
+#include "2131N/utils/battery.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/util.hpp"
+
+Chassis::Chassis(
+    lemlib::Drivetrain drivetrain,
+    lemlib::ControllerSettings lateral_settings,
+    lemlib::ControllerSettings angular_settings,
+    lemlib::OdomSensors sensors,
+    SettleSettings lateral_settle,
+    SettleSettings angular_settle,
+    PredictorSettings predictor_settings,
+    VelocityController drive_velocity,
+    TractionSettings traction_settings)
+    : lemlib::Chassis(drivetrain, lateral_settings, angular_settings, sensors),
+      lateral_settle_(lateral_settle),
+      angular_settle_(angular_settle),
+      pose_predictor_(predictor_settings),
+      monitor_task_(
+          [this]() {
+            uint32_t watched_id = 0;
+            while (true)
+            {
+              pros::delay(10);
+              this->updatePrediction();
+              this->checkSettle(watched_id);
+            }
+          },
+          "Chassis Monitor"),
+      left_velocity_(drive_velocity),
+      right_velocity_(drive_velocity),
+      left_command_(drivetrain.leftMotors),
+      right_command_(drivetrain.rightMotors),
+      traction_(traction_settings),
+      velocity_task_(
+          [this]() {
+            // Motors take a new command every 10ms, so run in step with them
+            uint32_t last_wake = pros::millis();
+            while (true)
+            {
+              this->updateDriveVelocity();
+              pros::Task::delay_until(&last_wake, 10);
+            }
+          },
+          TASK_PRIORITY_DEFAULT + 1,
+          TASK_STACK_DEPTH_DEFAULT,
+          "Drive Velocity")
+{
+}
+
+void Chassis::moveToPoint(float x, float y, int timeout, lemlib::MoveToPointParams p, bool async)
+{
+  // Always start lemlib async so the target can be recorded once the motion is running
+  this->beginMotion();
+  this->lemlib::Chassis::moveToPoint(x, y, timeout, p, true);
+  this->trackMotion({MotionType::POINT, x, y, 0.0f, p.forwards, p.minSpeed == 0});
+
+  if (!async) { this->waitUntilDone(); }
+}
+
+void Chassis::moveToPose(
+    float x, float y, float theta, int timeout, lemlib::MoveToPoseParams p, bool async)
+{
+  this->beginMotion();
+  this->lemlib::Chassis::moveToPose(x, y, theta, timeout, p, true);
+  this->trackMotion({MotionType::POSE, x, y, theta, p.forwards, p.minSpeed == 0});
+
+  if (!async) { this->waitUntilDone(); }
+}
+
+void Chassis::turnToHeading(float theta, int timeout, lemlib::TurnToHeadingParams p, bool async)
+{
+  this->beginMotion();
+  this->lemlib::Chassis::turnToHeading(theta, timeout, p, true);
+  this->trackMotion({MotionType::HEADING, 0.0f, 0.0f, theta, true, p.minSpeed == 0});
+
+  if (!async) { this->waitUntilDone(); }
+}
+
+void Chassis::turnToPoint(float x, float y, int timeout, lemlib::TurnToPointParams p, bool async)
+{
+  this->beginMotion();
+  this->lemlib::Chassis::turnToPoint(x, y, timeout, p, true);
+  this->trackMotion({MotionType::FACE_POINT, x, y, 0.0f, p.forwards, p.minSpeed == 0});
+
+  if (!async) { this->waitUntilDone(); }
+}
+
+void Chassis::swingToHeading(
+    float theta,
+    lemlib::DriveSide locked_side,
+    int timeout,
+    lemlib::SwingToHeadingParams p,
+    bool async)
+{
+  this->beginMotion();
+  this->lemlib::Chassis::swingToHeading(theta, locked_side, timeout, p, true);
+  this->trackMotion({MotionType::NONE});
+
+  if (!async) { this->waitUntilDone(); }
+}
+
+void Chassis::swingToPoint(
+    float x,
+    float y,
+    lemlib::DriveSide locked_side,
+    int timeout,
+    lemlib::SwingToPointParams p,
+    bool async)
+{
+  this->beginMotion();
+  this->lemlib::Chassis::swingToPoint(x, y, locked_side, timeout, p, true);
+  this->trackMotion({MotionType::NONE});
+
+  if (!async) { this->waitUntilDone(); }
+}
+
+void Chassis::follow(const asset& path, float lookahead, int timeout, bool forwards, bool async)
+{
+  this->beginMotion();
+  this->lemlib::Chassis::follow(path, lookahead, timeout, forwards, true);
+  this->trackMotion({MotionType::NONE});
+
+  if (!async) { this->waitUntilDone(); }
+}
+
+void Chassis::followPath(const Path& path, int timeout, FollowPathParams p, bool async)
+{
+  this->beginMotion();
+  this->requestMotionStart();
+  this->trackMotion({MotionType::NONE});
+
+  // were all motions cancelled?
+  if (!this->motionRunning) { return; }
+
+  // Run the motion on its own thread, the same way lemlib handles async motions
+  if (async)
+  {
+    pros::Task task([this, &path, timeout, p]() { this->followPath(path, timeout, p, false); });
+    this->endMotion();
+    pros::delay(10);
+    return;
+  }
+
+  // Nothing to follow
+  if (path.getSegmentCount() == 0)
+  {
+    this->endMotion();
+    return;
+  }
+
+  const float max_speed = pose_predictor_.getSettings().max_speed;
+  const float track_width = drivetrain.trackWidth;
+  const size_t last_segment = path.getSegmentCount() - 1;
+  const lemlib::Pose end_point(path.getPoints().back().x, path.getPoints().back().y);
+
+  size_t cursor = 0;
+  distTraveled = 0;
+  uint32_t start = pros::millis();
+  uint32_t last_wake = start;
+
+  while (this->motionRunning && pros::millis() - start < static_cast<uint32_t>(timeout))
+  {
+    lemlib::Pose pose = this->getPose(true);
+    if (!p.forwards) { pose.theta += M_PI; }
+
+    // Closest point only moves forwards along the path (theta holds the segment fraction)
+    lemlib::Pose closest = path.closestPoint(pose, cursor);
+    distTraveled = path.distanceAt(cursor, closest.theta);
+
+    // Done within tolerance of the end, or once past it (the closest point is pinned to the end)
+    bool at_end = pose.distance(end_point) <= p.end_tolerance || closest.theta >= 1.0f;
+    if (cursor == last_segment && at_end) { break; }
+
+    // Look further ahead the faster the robot is going
+    float speed_fraction = std::clamp(std::fabs(lemlib::getLocalSpeed().y) / max_speed, 0.0f, 1.0f);
+    float lookahead = p.min_lookahead + (p.max_lookahead - p.min_lookahead) * speed_fraction;
+    lemlib::Pose target = path.lookaheadPoint(pose, lookahead, cursor);
+
+    // Curvature of the arc to the lookahead point (positive curves clockwise)
+    float dx = target.x - pose.x;
+    float dy = target.y - pose.y;
+    float lateral = dx * std::cos(pose.theta) - dy * std::sin(pose.theta);
+    float distance_squared = dx * dx + dy * dy;
+    float curvature = distance_squared > 1e-6f ? 2.0f * lateral / distance_squared : 0.0f;
+
+    // Split the profiled speed between the sides, keeping the ratio if one saturates
+    float target_speed = path.speedAt(cursor, closest.theta);
+    float left = target_speed * (2.0f + curvature * track_width) / 2.0f;
+    float right = target_speed * (2.0f - curvature * track_width) / 2.0f;
+    float ratio = std::max(std::fabs(left), std::fabs(right)) / max_speed;
+    if (ratio > 1.0f)
+    {
+      left /= ratio;
+      right /= ratio;
+    }
+
+    // Driving backwards swaps the sides of the virtual front
+    if (!p.forwards)
+    {
+      float swap = left;
+      left = -right;
+      right = -swap;
+    }
+
+    this->setDriveVelocity(left, right);
+
+    pros::Task::delay_until(&last_wake, 10);
+  }
+
+  this->stopDriveVelocity();
+  distTraveled = -1;
+  this->endMotion();
+}
 
 void Chassis::moveToRelativePose(
     const lemlib::Pose& deltaPose, int timeout, lemlib::MoveToPoseParams p, bool async)
 {
-  lemlib::Pose targetPose = this->getPose() + deltaPose;
+  lemlib::Pose targetPose = this->getMotionEndPose() + deltaPose;
   this->moveToPose(
       targetPose.x, targetPose.y, targetPose.theta + deltaPose.theta, timeout, p, async);
 }
@@ -13,31 +232,27 @@ void Chassis::moveToRelativePose(
 void Chassis::moveToPointAsPose(
     const lemlib::Pose& point, int timeout, lemlib::MoveToPointParams p, bool async)
 {
-  this->lemlib::Chassis::moveToPoint(point.x, point.y, timeout, p, async);
+  this->moveToPoint(point.x, point.y, timeout, p, async);
 }
 
 void Chassis::moveToRelativePoint(
     const lemlib::Pose& deltaPoint, int timeout, lemlib::MoveToPointParams p, bool async)
 {
-  this->waitUntilDone();
-  lemlib::Pose targetPoint = this->getPose() + deltaPoint;
-  this->lemlib::Chassis::moveToPoint(targetPoint.x, targetPoint.y, timeout, p, async);
+  lemlib::Pose targetPoint = this->getMotionEndPose() + deltaPoint;
+  this->moveToPoint(targetPoint.x, targetPoint.y, timeout, p, async);
 }
 
 void Chassis::moveToRelativePoint(
     float x, float y, int timeout, lemlib::MoveToPointParams p, bool async)
 {
-  this->waitUntilDone();
-  lemlib::Pose targetPoint = this->getPose() + lemlib::Pose(x, y, 0);
-  this->lemlib::Chassis::moveToPoint(targetPoint.x, targetPoint.y, timeout, p, async);
+  lemlib::Pose targetPoint = this->getMotionEndPose() + lemlib::Pose(x, y, 0);
+  this->moveToPoint(targetPoint.x, targetPoint.y, timeout, p, async);
 }
 
 void Chassis::turnToRelativeHeading(
     float deltaHeading, int timeout, lemlib::TurnToHeadingParams p, bool async)
 {
-  this->waitUntilDone();
-
-  this->turnToHeading(this->getPose().theta + deltaHeading, timeout, p, async);
+  this->turnToHeading(this->getMotionEndPose().theta + deltaHeading, timeout, p, async);
 }
 
 lemlib::Pose Chassis::fromPolar(float r, float theta, bool radians)
@@ -51,5 +266,342 @@ void Chassis::tank_with_dead_zone(
 {
   if (std::abs(left_speed) < dead_zone) left_speed = 0;
   if (std::abs(right_speed) < dead_zone) right_speed = 0;
-  this->lemlib::Chassis::tank(left_speed, right_speed, !drive_curve);
-}
\ No newline at end of file
+
+  if (drive_curve)
+  {
+    left_speed = throttleCurve->curve(left_speed);
+    right_speed = throttleCurve->curve(right_speed);
+  }
+
+  this->tank(left_speed, right_speed);
+}
+
+void Chassis::tank(float left, float right)
+{
+  // Full stick is the top speed of the drivetrain
+  const float max_speed = pose_predictor_.getSettings().max_speed;
+  this->setDriveVelocity(left / 127.0f * max_speed, right / 127.0f * max_speed);
+}
+
+void Chassis::setDriveVelocity(float left, float right)
+{
+  velocity_mutex_.take();
+  // Coming from voltage control, start the loops from rest (lemlib had the motors, so the last
+  // commands sent from here are stale)
+  if (!velocity_control_)
+  {
+    left_velocity_.reset();
+    right_velocity_.reset();
+    left_command_.invalidate();
+    right_command_.invalidate();
+    traction_.reset(
+        this->getSideVelocity(drivetrain.leftMotors),
+        this->getSideVelocity(drivetrain.rightMotors));
+  }
+  left_target_ = left;
+  right_target_ = right;
+  velocity_control_ = true;
+  velocity_mutex_.give();
+}
+
+void Chassis::setTractionControl(bool enabled)
+{
+  velocity_mutex_.take();
+  if (enabled && !traction_control_)
+  {
+    traction_.reset(
+        this->getSideVelocity(drivetrain.leftMotors),
+        this->getSideVelocity(drivetrain.rightMotors));
+  }
+  traction_control_ = enabled;
+  velocity_mutex_.give();
+}
+
+void Chassis::stopDriveVelocity()
+{
+  velocity_mutex_.take();
+  velocity_control_ = false;
+  left_target_ = 0.0f;
+  right_target_ = 0.0f;
+  // Always sent, lemlib may have driven the motors since the last command from here
+  left_command_.invalidate();
+  right_command_.invalidate();
+  left_command_.moveVoltage(0);
+  right_command_.moveVoltage(0);
+  velocity_mutex_.give();
+}
+
+void Chassis::beginMotion()
+{
+  // lemlib motions command voltages directly, so hand the motors back to them
+  velocity_mutex_.take();
+  velocity_control_ = false;
+  velocity_mutex_.give();
+
+  tracked_mutex_.take();
+  pending_motions_++;
+  tracked_mutex_.give();
+}
+
+void Chassis::trackMotion(TrackedMotion motion)
+{
+  tracked_mutex_.take();
+  motion.id = tracked_motion_.id + 1;
+  tracked_motion_ = motion;
+  if (pending_motions_ > 0) { pending_motions_--; }
+  tracked_mutex_.give();
+}
+
+lemlib::Pose Chassis::getPredictedPose(float time)
+{
+  predictor_mutex_.take();
+  lemlib::Pose predicted = pose_predictor_.predict(time);
+  predictor_mutex_.give();
+
+  return predicted;
+}
+
+bool Chassis::predictMotionEnd(lemlib::Pose& end_pose)
+{
+  if (!this->isInMotion())
+  {
+    end_pose = this->getPose();
+    return true;
+  }
+
+  tracked_mutex_.take();
+  TrackedMotion motion = tracked_motion_;
+  bool target_stale = pending_motions_ > 0 && !this->motionQueued;
+  tracked_mutex_.give();
+
+  // Only motions that settle on their target have a known end
+  if (!motion.settle || target_stale || motion.type == MotionType::NONE) { return false; }
+
+  predictor_mutex_.take();
+  lemlib::Pose stop = pose_predictor_.predictStop();
+  PredictorSettings settings = pose_predictor_.getSettings();
+  predictor_mutex_.give();
+
+  switch (motion.type)
+  {
+    case MotionType::POINT:
+      end_pose = lemlib::Pose(motion.x, motion.y, stop.theta);
+      return stop.distance(end_pose) <= settings.end_tolerance;
+    case MotionType::POSE:
+      end_pose = lemlib::Pose(motion.x, motion.y, motion.theta);
+      return stop.distance(end_pose) <= settings.end_tolerance &&
+             std::fabs(lemlib::angleError(motion.theta, stop.theta, false)) <=
+                 settings.end_angular_tolerance;
+    case MotionType::HEADING:
+      end_pose = lemlib::Pose(stop.x, stop.y, motion.theta);
+      return std::fabs(lemlib::angleError(motion.theta, stop.theta, false)) <=
+             settings.end_angular_tolerance;
+    case MotionType::FACE_POINT: {
+      float target_heading =
+          lemlib::radToDeg(std::atan2(motion.x - stop.x, motion.y - stop.y)) +
+          (motion.forwards ? 0.0f : 180.0f);
+      end_pose = lemlib::Pose(stop.x, stop.y, target_heading);
+      return std::fabs(lemlib::angleError(target_heading, stop.theta, false)) <=
+             settings.end_angular_tolerance;
+    }
+    default:
+      return false;
+  }
+}
+
+bool Chassis::waitUntilNear(float x, float y, float radius, float lead_time, int timeout)
+{
+  uint32_t start = pros::millis();
+  lemlib::Pose point(x, y);
+
+  while (pros::millis() - start < static_cast<uint32_t>(timeout))
+  {
+    // Compare against where the chassis will be once the following action takes effect
+    if (this->getPredictedPose(lead_time).distance(point) <= radius) { return true; }
+    if (!this->isInMotion()) { return this->getPose().distance(point) <= radius; }
+
+    pros::delay(10);
+  }
+
+  return false;
+}
+
+lemlib::Pose Chassis::getMotionEndPose()
+{
+  // Issue the next motion as soon as the end of this one is known instead of waiting it out
+  lemlib::Pose end_pose(0, 0, 0);
+  while (!this->predictMotionEnd(end_pose)) { pros::delay(10); }
+
+  return end_pose;
+}
+
+void Chassis::updatePrediction()
+{
+  lemlib::Pose pose = this->getPose(true);
+  float velocity = lemlib::getLocalSpeed(true).y;
+  float angular_velocity = lemlib::getSpeed(true).theta;
+  float left_voltage = drivetrain.leftMotors->get_voltage();
+  float right_voltage = drivetrain.rightMotors->get_voltage();
+
+  // Under velocity control the targets are where the sides are headed, whatever the battery
+  velocity_mutex_.take();
+  if (velocity_control_)
+  {
+    const float max_speed = pose_predictor_.getSettings().max_speed;
+    left_voltage = left_target_ / max_speed * 12000.0f;
+    right_voltage = right_target_ / max_speed * 12000.0f;
+  }
+  velocity_mutex_.give();
+
+  predictor_mutex_.take();
+  pose_predictor_.update(pose, velocity, angular_velocity, left_voltage, right_voltage);
+  predictor_mutex_.give();
+
+  telemetry.log<TelemetryChannel::ODOMETRY>(
+      {pose.x, pose.y, lemlib::radToDeg(pose.theta), velocity, angular_velocity});
+}
+
+void Chassis::checkSettle(uint32_t& watched_id)
+{
+  // Copy the tracked motion so lemlib isn't held up by this thread
+  tracked_mutex_.take();
+  TrackedMotion motion = tracked_motion_;
+  // A motion call that hasn't recorded its target yet may already be running (unless it's
+  // still queued behind the tracked one), so the tracked target can't be trusted
+  bool target_stale = pending_motions_ > 0 && !this->motionQueued;
+  tracked_mutex_.give();
+
+  if (!motion.settle || target_stale || !this->isInMotion()) { return; }
+
+  // New motion, start the detectors from scratch
+  if (motion.id != watched_id)
+  {
+    watched_id = motion.id;
+    lateral_settle_.reset();
+    angular_settle_.reset();
+  }
+
+  // The projected exit assumes the drive brakes once the motion ends, a coasting drive doesn't
+  // stop where it says
+  pros::MotorBrake brake_mode = drivetrain.leftMotors->get_brake_mode();
+  bool braking = brake_mode == pros::MotorBrake::brake || brake_mode == pros::MotorBrake::hold;
+  lateral_settle_.setProjection(braking);
+  angular_settle_.setProjection(braking);
+
+  lemlib::Pose pose = this->getPose();
+  lemlib::Pose speed = lemlib::getSpeed();
+  bool settled = true;
+
+  if (motion.type == MotionType::POINT || motion.type == MotionType::POSE)
+  {
+    float error = pose.distance(lemlib::Pose(motion.x, motion.y));
+    settled &= lateral_settle_.update(error, std::hypot(speed.x, speed.y));
+  }
+
+  if (motion.type != MotionType::POINT)
+  {
+    float target_heading = motion.theta;
+    if (motion.type == MotionType::FACE_POINT)
+    {
+      // lemlib headings are measured clockwise from +y
+      target_heading = lemlib::radToDeg(std::atan2(motion.x - pose.x, motion.y - pose.y));
+      if (!motion.forwards) { target_heading += 180.0f; }
+    }
+    float error = lemlib::angleError(target_heading, pose.theta, false);
+    settled &= angular_settle_.update(error, speed.theta);
+  }
+
+  if (!settled) { return; }
+
+  // Only end the motion if it is still the one that settled
+  tracked_mutex_.take();
+  bool same_motion =
+      tracked_motion_.id == watched_id && !(pending_motions_ > 0 && !this->motionQueued);
+  tracked_mutex_.give();
+
+  if (same_motion)
+  {
+    this->cancelMotion();
+
+    // lemlib leaves the last voltage on the motors, stop them so the robot brakes from here
+    velocity_mutex_.take();
+    left_command_.invalidate();
+    right_command_.invalidate();
+    left_command_.brake(brake_mode);
+    right_command_.brake(brake_mode);
+    velocity_mutex_.give();
+
+    telemetry.info<"Motion {} ended on settle">(watched_id);
+  }
+}
+
+void Chassis::updateDriveVelocity()
+{
+  velocity_mutex_.take();
+  if (!velocity_control_)
+  {
+    velocity_mutex_.give();
+    return;
+  }
+
+  float left_velocity = this->getSideVelocity(drivetrain.leftMotors);
+  float right_velocity = this->getSideVelocity(drivetrain.rightMotors);
+
+  // Change speed only as fast as the wheels can grip
+  float left_target = left_target_;
+  float right_target = right_target_;
+  if (traction_control_)
+  {
+    std::tie(left_target, right_target) = traction_.update(
+        left_target_,
+        right_target_,
+        {left_velocity, right_velocity, this->getForwardAccel(), this->getPose(true).theta},
+        0.01f);
+  }
+
+  float left_voltage = left_velocity_.calculate(left_velocity, left_target);
+  float right_voltage = right_velocity_.calculate(right_velocity, right_target);
+
+  // The controllers work in voltage at the motor, correct for what the battery can give
+  left_command_.moveVoltage(batteryCompensate(left_voltage));
+  right_command_.moveVoltage(batteryCompensate(right_voltage));
+  velocity_mutex_.give();
+}
+
+float Chassis::getSideVelocity(pros::MotorGroup* motors)
+{
+  float cartridge_rpm;
+  switch (motors->get_gearing())
+  {
+    case pros::MotorGears::red: cartridge_rpm = 100.0f; break;
+    case pros::MotorGears::green: cartridge_rpm = 200.0f; break;
+    default: cartridge_rpm = 600.0f; break;
+  }
+
+  // Average the motors that are reporting (unplugged motors return PROS_ERR_F)
+  float total = 0.0f;
+  int count = 0;
+  for (double rpm : motors->get_actual_velocity_all())
+  {
+    if (!std::isfinite(rpm)) { continue; }
+    total += rpm;
+    count++;
+  }
+  if (count == 0) { return 0.0f; }
+
+  // Motor rpm -> wheel rpm -> in/s
+  float wheel_rpm = total / count * drivetrain.rpm / cartridge_rpm;
+  return wheel_rpm * M_PI * drivetrain.wheelDiameter / 60.0f;
+}
+
+float Chassis::getForwardAccel()
+{
+  if (sensors.imu == nullptr) { return 0.0f; }
+
+  pros::imu_accel_s_t accel = sensors.imu->get_accel();
+  if (!std::isfinite(accel.x) || !std::isfinite(accel.y)) { return 0.0f; }
+
+  // The IMU reads in g
+  const TractionSettings& settings = traction_.getSettings();
+  return (accel.x * settings.imu_forward_x + accel.y * settings.imu_forward_y) * 386.09f;
+}
@@ -0,0 +1,45 @@
+#include "2131N/systems/controller_input.hpp"
+
+#include "pros/rtos.hpp"
+
+const ControllerSnapshot& ControllerInput::update()
+{
+  uint16_t held = 0;
+  for (int i = 0; i < ControllerSnapshot::kButtons; i++)
+  {
+    auto button = static_cast<pros::controller_digital_e_t>(pros::E_CONTROLLER_DIGITAL_L1 + i);
+    if (controller_->get_digital(button)) { held |= ControllerSnapshot::bit(button); }
+  }
+
+  std::array<int8_t, 4> analog;
+  for (int channel = 0; channel < 4; channel++)
+  {
+    analog[channel] = static_cast<int8_t>(
+        controller_->get_analog(static_cast<pros::controller_analog_e_t>(channel)));
+  }
+
+  uint16_t previous = last_.held;
+  last_ = {
+      pros::millis(),
+      last_.sequence + 1,
+      analog,
+      held,
+      static_cast<uint16_t>(held & ~previous),
+      static_cast<uint16_t>(previous & ~held)};
+
+  // If a reader is still copying the other buffer they get this sample next tick
+  if (ControllerSnapshot* buffer = published_.beginWrite(); buffer != nullptr)
+  {
+    *buffer = last_;
+    published_.publish();
+  }
+
+  return last_;
+}
+
+ControllerSnapshot ControllerInput::get() const
+{
+  ControllerSnapshot snapshot;
+  published_.read(snapshot);
+  return snapshot;
+}
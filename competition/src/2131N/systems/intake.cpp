@@ -1 +1,282 @@
 #include "2131N/systems/intake.hpp"
+
+#include "2131N/utils/battery.hpp"
+
+Intake::Intake(
+    pros::MotorGroup* bottom_stage,
+    pros::Motor* middle_stage,
+    pros::Motor* top_stage,
+    pros::Distance* bottom_detector,
+    pros::adi::Pneumatics* middle_gate,
+    float detection_range,
+    pros::controller_digital_e_t intake_button,
+    pros::controller_digital_e_t outtake_button,
+    pros::controller_digital_e_t score_top_button,
+    pros::controller_digital_e_t score_middle_button,
+    VelocityController stage_velocity,
+    const JamSettings& jam_settings,
+    const BallTrackerSettings& ball_settings)
+    : bottom_stage_(bottom_stage),
+      middle_stage_(middle_stage),
+      top_stage_(top_stage),
+      middle_stage_gate_(middle_gate),
+      stage_commands_{
+          MotorCommand(bottom_stage), MotorCommand(middle_stage), MotorCommand(top_stage)},
+      middle_gate_command_(middle_gate),
+      bottom_detector_(bottom_detector),
+      detection_range_(detection_range),
+      intake_button_(intake_button),
+      outtake_button_(outtake_button),
+      score_top_button_(score_top_button),
+      score_middle_button(score_middle_button),
+      ball_tracker_(ball_settings),
+      jam_settings_(jam_settings),
+      jam_detectors_{
+          JamDetector(&jam_settings_), JamDetector(&jam_settings_), JamDetector(&jam_settings_)},
+      stage_velocity_{stage_velocity, stage_velocity, stage_velocity}
+{
+}
+
+void Intake::teleOp(const ControllerSnapshot& input)
+{
+  bool intake_pressed = input.isPressed(intake_button_);
+  bool outtake_pressed = input.isPressed(outtake_button_);
+  bool released = input.isReleased(intake_button_) || input.isReleased(outtake_button_);
+  bool score_pressed = input.isPressed(score_top_button_);
+  bool intake_held = input.isHeld(intake_button_);
+
+  machine_mutex_.take();
+  IntakeContext& context = machine_.getContext();
+  context.intake_held = intake_held;
+  uint32_t now = pros::millis();
+
+  if (intake_pressed) { machine_.dispatch(IntakeEvent::INTAKE_PRESSED, now); }
+  else if (outtake_pressed) { machine_.dispatch(IntakeEvent::OUTTAKE_PRESSED, now); }
+  else if (released) { machine_.dispatch(IntakeEvent::RELEASED, now); }
+
+  if (score_pressed)
+  {
+    context.score_mode = !context.score_mode;
+    machine_.dispatch(IntakeEvent::SCORE_MODE_CHANGED, now);
+  }
+  machine_mutex_.give();
+}
+
+void Intake::setState(states new_state)
+{
+  machine_mutex_.take();
+  machine_.force(new_state, pros::millis());
+  machine_mutex_.give();
+}
+
+Intake::states Intake::getState()
+{
+  machine_mutex_.take();
+  states state = machine_.getState();
+  machine_mutex_.give();
+  return state;
+}
+
+void Intake::antiJam(bool anti_jam)
+{
+  if (anti_jam) { this->post(IntakeEvent::JAM); }
+  else { this->post(IntakeEvent::TIMEOUT); }
+}
+
+size_t Intake::getHeld()
+{
+  machine_mutex_.take();
+  size_t held = ball_tracker_.getHeld();
+  machine_mutex_.give();
+  return held;
+}
+
+uint32_t Intake::getScored()
+{
+  machine_mutex_.take();
+  uint32_t scored = ball_tracker_.getScored();
+  machine_mutex_.give();
+  return scored;
+}
+
+float Intake::getScoreRate()
+{
+  machine_mutex_.take();
+  float rate = ball_tracker_.getScoreRate(pros::millis());
+  machine_mutex_.give();
+  return rate;
+}
+
+void Intake::addStored(size_t count)
+{
+  machine_mutex_.take();
+  ball_tracker_.addStored(count);
+  machine_mutex_.give();
+}
+
+bool Intake::waitUntilScored(uint32_t count, uint32_t timeout)
+{
+  uint32_t target = this->getScored() + count;
+  uint32_t start = pros::millis();
+  while (this->getScored() < target)
+  {
+    if (pros::millis() - start >= timeout) { return false; }
+    pros::delay(10);
+  }
+  return true;
+}
+
+bool Intake::waitUntilEmpty(uint32_t timeout)
+{
+  uint32_t start = pros::millis();
+  while (this->getHeld() > 0)
+  {
+    if (pros::millis() - start >= timeout) { return false; }
+    pros::delay(10);
+  }
+  return true;
+}
+
+void Intake::post(IntakeEvent event)
+{
+  machine_mutex_.take();
+  machine_.dispatch(event, pros::millis());
+  machine_mutex_.give();
+}
+
+void Intake::update()
+{
+  ball_detected_ = (bottom_detector_->get() < detection_range_);
+  bool ball_changed = ball_detector.checkValue(ball_detected_);
+
+  // How far each stage has turned, from the brain's cached motor data
+  std::array<pros::AbstractMotor*, 3> stages = {bottom_stage_, middle_stage_, top_stage_};
+  std::array<float, 3> travel;
+  for (size_t stage = 0; stage < stages.size(); stage++)
+  {
+    double position = stages[stage]->get_position();
+    travel[stage] = static_cast<float>(position - last_positions_[stage]);
+    last_positions_[stage] = position;
+  }
+
+  machine_mutex_.take();
+  uint32_t now = pros::millis();
+  machine_.getContext().ball_detected = ball_detected_;
+  if (ball_changed)
+  {
+    machine_.dispatch(ball_detected_ ? IntakeEvent::BALL_ENTERED : IntakeEvent::BALL_CLEARED, now);
+
+    // Only a ball being pulled in is new, one going out passes the detector too
+    if (ball_detected_ && stage_commands_[0].getValue() > 0) { ball_tracker_.ballEntered(); }
+  }
+  ball_tracker_.update(travel, now);
+  machine_.getContext().storage_full = ball_tracker_.isHeldBack(1);
+  machine_.update(now);
+
+  // Walk the unjam sequence by time in the state, then go back to what was interrupted
+  const UnjamStep* unjam_step = nullptr;
+  if (machine_.getState() == states::ANTI_JAM)
+  {
+    uint32_t elapsed = machine_.getTimeInState(now);
+    uint32_t step_end = 0;
+    for (size_t i = 0; i < jam_settings_.unjam_steps; i++)
+    {
+      step_end += jam_settings_.unjam[i].duration;
+      if (elapsed < step_end)
+      {
+        unjam_step = &jam_settings_.unjam[i];
+        break;
+      }
+    }
+    if (unjam_step == nullptr) { machine_.dispatch(IntakeEvent::TIMEOUT, now); }
+  }
+
+  states state = machine_.getState();
+  const IntakeStateInfo& info = machine_.getInfo();
+  std::array<bool, 3> watched;
+  for (size_t stage = 0; stage < watched.size(); stage++)
+  {
+    watched[stage] = machine_.checksJams(stage);
+  }
+  machine_mutex_.give();
+
+  // Drive each stage from the unjam step, or the state's row of the table
+  for (size_t stage = 0; stage < stage_commands_.size(); stage++)
+  {
+    int16_t velocity = unjam_step == nullptr && !info.brake ? info.velocity[stage] : kIntakeKeep;
+    if (closed_loop_ && velocity != kIntakeKeep)
+    {
+      float target = info.scaled ? velocity * intake_multipliers[stage] : velocity;
+      float voltage =
+          stage_velocity_[stage].calculate(stages[stage]->get_actual_velocity(), target);
+      stage_targets_[stage] = static_cast<int32_t>(target);
+
+      // The loop works in voltage at the motor, correct for what the battery can give
+      stage_commands_[stage].moveVoltage(batteryCompensate(voltage));
+      continue;
+    }
+
+    // Open loop, the velocity loop starts over next time it is used
+    stage_velocity_[stage].reset();
+
+    int16_t voltage = unjam_step != nullptr ? unjam_step->voltage[stage] : info.voltage[stage];
+    if (voltage == kIntakeKeep) { continue; }
+    stage_targets_[stage] = voltage;
+
+    if (unjam_step == nullptr && info.brake)
+    {
+      stage_commands_[stage].brake(pros::MotorBrake::coast);
+    }
+    else if (unjam_step == nullptr && info.scaled)
+    {
+      stage_commands_[stage].moveVoltage(voltage * intake_multipliers[stage]);
+    }
+    else { stage_commands_[stage].moveVoltage(voltage); }
+  }
+
+  // Jams only make sense while pulling balls in, anywhere else the windows start over
+  if (jam_detection_) { this->checkJams(now, watched); }
+  else
+  {
+    for (JamDetector& detector : jam_detectors_) { detector.reset(now); }
+  }
+
+  telemetry.log<TelemetryChannel::INTAKE>(
+      {static_cast<uint8_t>(state),
+       ball_detected_,
+       state == states::ANTI_JAM,
+       0,
+       static_cast<int16_t>(bottom_stage_->get_voltage()),
+       static_cast<int16_t>(middle_stage_->get_voltage()),
+       static_cast<int16_t>(top_stage_->get_voltage())});
+}
+
+void Intake::checkJams(uint32_t now, const std::array<bool, 3>& watched)
+{
+  std::array<pros::AbstractMotor*, 3> stages = {bottom_stage_, middle_stage_, top_stage_};
+
+  for (size_t stage = 0; stage < stages.size(); stage++)
+  {
+    // A stage that is meant to stall starts its window over once it is watched again
+    if (!watched[stage])
+    {
+      jam_detectors_[stage].reset(now);
+      continue;
+    }
+
+    // Motor readings come from the brain's cached device data, no port traffic
+    StageSample sample{
+        stage_targets_[stage],
+        stage_commands_[stage].getValue(),
+        static_cast<float>(stages[stage]->get_actual_velocity()),
+        static_cast<float>(stages[stage]->get_current_draw()),
+        static_cast<float>(stages[stage]->get_torque())};
+
+    if (!jam_detectors_[stage].update(sample, now)) { continue; }
+
+    telemetry.info<"Intake stage {} jammed, unjamming">(stage);
+    for (JamDetector& detector : jam_detectors_) { detector.reset(now); }
+    this->post(IntakeEvent::JAM);
+    return;
+  }
+}
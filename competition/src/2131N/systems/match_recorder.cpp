@@ -0,0 +1,339 @@
+#include "2131N/systems/match_recorder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "lemlib/chassis/odom.hpp"
+#include "pros/misc.hpp"
+
+MatchRecorder::MatchRecorder(
+    Chassis* chassis,
+    Intake* intake,
+    std::vector<DistanceSensor*> distance_sensors,
+    std::vector<pros::AbstractMotor*> motors,
+    std::function<MclSample()> mcl_sample,
+    uint32_t period)
+    : chassis_(chassis),
+      intake_(intake),
+      distance_sensors_(std::move(distance_sensors)),
+      motors_(std::move(motors)),
+      mcl_sample_(std::move(mcl_sample)),
+      period_(period),
+      sample_task_(
+          [this]() {
+            uint32_t last_wake = pros::millis();
+            while (true)
+            {
+              this->update();
+              pros::Task::delay_until(&last_wake, period_);
+            }
+          },
+          "Match Recorder"),
+      writer_task_(
+          [this]() {
+            while (true)
+            {
+              // Woken on every hand-off, the timeout catches a stop with nothing left to write
+              pros::Task::notify_take(true, 100);
+              this->write();
+            }
+          },
+          TASK_PRIORITY_MIN + 1,
+          TASK_STACK_DEPTH_DEFAULT,
+          "Match Writer")
+{
+}
+
+bool MatchRecorder::start()
+{
+  mutex_.take();
+  if (recording_.load())
+  {
+    mutex_.give();
+    return true;
+  }
+
+  // Still finishing the last recording
+  if (file_ != nullptr || !pros::usd::is_installed())
+  {
+    mutex_.give();
+    return false;
+  }
+
+  // Never overwrite an old match
+  char path[32];
+  for (int i = 0; i < 1000 && file_ == nullptr; i++)
+  {
+    snprintf(path, sizeof(path), "/usd/match_%03d.bin", i);
+    FILE* existing = fopen(path, "rb");
+    if (existing != nullptr)
+    {
+      fclose(existing);
+      continue;
+    }
+    file_ = fopen(path, "wb");
+    if (file_ == nullptr) { break; }
+  }
+
+  if (file_ == nullptr)
+  {
+    mutex_.give();
+    return false;
+  }
+
+  active_ = 0;
+  sequence_ = 0;
+  frame_count_ = 0;
+  open_block_ = nullptr;
+  index_count_ = 0;
+
+  // The header block goes through the buffers like everything else
+  uint8_t* block = this->nextBlock();
+  std::memset(block, 0, kMatchBlockSize);
+  MatchBlockHeader header{
+      kMatchMagic,
+      static_cast<uint8_t>(MatchBlockType::HEADER),
+      kMatchVersion,
+      1,
+      sequence_++,
+      pros::millis()};
+  MatchFileInfo info{
+      sizeof(MatchFrame),
+      kMatchFramesPerBlock,
+      0,
+      static_cast<uint16_t>(std::min(distance_sensors_.size(), kMatchMaxDistances)),
+      period_,
+      pros::millis()};
+
+  // Count the motors actually being recorded
+  size_t motor_count = 0;
+  for (pros::AbstractMotor* motor : motors_) { motor_count += motor->size(); }
+  info.motor_count = std::min(motor_count, kMatchMaxMotors);
+
+  std::memcpy(block, &header, sizeof(header));
+  std::memcpy(block + sizeof(header), &info, sizeof(info));
+
+  recording_.store(true);
+  mutex_.give();
+
+  return true;
+}
+
+void MatchRecorder::stop()
+{
+  mutex_.take();
+  if (!recording_.load())
+  {
+    mutex_.give();
+    return;
+  }
+  recording_.store(false);
+
+  // Flush the partial block, index it and hand over whatever is left
+  this->closeDataBlock();
+  if (index_count_ > 0) { this->writeIndex(); }
+  this->handOff();
+
+  closing_.store(true);
+  writer_task_.notify();
+  mutex_.give();
+}
+
+uint8_t* MatchRecorder::nextBlock()
+{
+  if (buffers_[active_].blocks == kBlocksPerBuffer) { this->handOff(); }
+
+  Buffer* buffer = &buffers_[active_];
+  if (buffer->pending.load())
+  {
+    // Active buffer was handed off while the other one was still being written
+    Buffer& other = buffers_[active_ ^ 1];
+    if (other.pending.load()) { return nullptr; }
+
+    active_ ^= 1;
+    buffer = &other;
+  }
+
+  uint8_t* block = buffer->data.data() + buffer->blocks * kMatchBlockSize;
+  buffer->blocks++;
+  return block;
+}
+
+void MatchRecorder::handOff()
+{
+  Buffer& buffer = buffers_[active_];
+  if (buffer.blocks == 0 || buffer.pending.load()) { return; }
+
+  buffer.order = handoffs_++;
+  buffer.pending.store(true);
+  writer_task_.notify();
+
+  // Carry on in the other buffer if it's free, otherwise nextBlock waits for it
+  if (!buffers_[active_ ^ 1].pending.load()) { active_ ^= 1; }
+}
+
+void MatchRecorder::closeDataBlock()
+{
+  if (open_block_ == nullptr) { return; }
+
+  MatchBlockHeader header{
+      kMatchMagic,
+      static_cast<uint8_t>(MatchBlockType::DATA),
+      kMatchVersion,
+      frame_count_,
+      sequence_,
+      block_timestamp_};
+  std::memcpy(open_block_, &header, sizeof(header));
+
+  // Zero the unused frames of a partial block
+  size_t used = sizeof(header) + frame_count_ * sizeof(MatchFrame);
+  std::memset(open_block_ + used, 0, kMatchBlockSize - used);
+
+  index_[index_count_++] = {sequence_, block_timestamp_};
+  sequence_++;
+  open_block_ = nullptr;
+  frame_count_ = 0;
+
+  if (index_count_ == kMatchIndexInterval) { this->writeIndex(); }
+
+  // Get full buffers to the card straight away
+  if (buffers_[active_].blocks == kBlocksPerBuffer) { this->handOff(); }
+}
+
+void MatchRecorder::writeIndex()
+{
+  uint8_t* block = this->nextBlock();
+  if (block != nullptr)
+  {
+    MatchBlockHeader header{
+        kMatchMagic,
+        static_cast<uint8_t>(MatchBlockType::INDEX),
+        kMatchVersion,
+        static_cast<uint16_t>(index_count_),
+        sequence_++,
+        pros::millis()};
+    std::memset(block, 0, kMatchBlockSize);
+    std::memcpy(block, &header, sizeof(header));
+    std::memcpy(block + sizeof(header), index_.data(), index_count_ * sizeof(MatchIndexEntry));
+  }
+
+  index_count_ = 0;
+  if (buffers_[active_].blocks == kBlocksPerBuffer) { this->handOff(); }
+}
+
+void MatchRecorder::sample(MatchFrame& frame)
+{
+  frame = {};
+  frame.timestamp = pros::millis();
+
+  lemlib::Pose pose = chassis_->getPose();
+  frame.x = pose.x;
+  frame.y = pose.y;
+  frame.theta = pose.theta;
+  frame.velocity = lemlib::getLocalSpeed().y;
+  frame.angular_velocity = lemlib::getSpeed().theta;
+
+  if (mcl_sample_)
+  {
+    MclSample mcl = mcl_sample_();
+    frame.mcl_x = mcl.x;
+    frame.mcl_y = mcl.y;
+    frame.mcl_variance = mcl.variance;
+  }
+
+  for (size_t i = 0; i < distance_sensors_.size() && i < kMatchMaxDistances; i++)
+  {
+    double reading = distance_sensors_[i]->get_distance_reading() * 100.0;
+    frame.distance[i] = static_cast<uint16_t>(std::clamp(reading, 0.0, 65535.0));
+  }
+
+  size_t slot = 0;
+  for (pros::AbstractMotor* motor : motors_)
+  {
+    for (uint8_t i = 0; i < motor->size() && slot < kMatchMaxMotors; i++, slot++)
+    {
+      frame.voltage[slot] = static_cast<int16_t>(motor->get_voltage(i));
+      frame.current[slot] = static_cast<int16_t>(motor->get_current_draw(i));
+      frame.temperature[slot] =
+          static_cast<uint8_t>(std::clamp(motor->get_temperature(i), 0.0, 255.0));
+    }
+  }
+
+  frame.battery_voltage = static_cast<uint16_t>(std::max<int32_t>(pros::battery::get_voltage(), 0));
+  frame.intake_state = static_cast<uint8_t>(intake_->getState());
+  frame.flags = intake_->isBallDetected() ? kMatchFlagBallDetected : 0;
+}
+
+void MatchRecorder::update()
+{
+  if (!recording_.load()) { return; }
+
+  MatchFrame frame;
+  this->sample(frame);
+
+  mutex_.take();
+  if (!recording_.load())
+  {
+    mutex_.give();
+    return;
+  }
+
+  if (open_block_ == nullptr)
+  {
+    open_block_ = this->nextBlock();
+    if (open_block_ == nullptr)
+    {
+      // Card can't keep up, lose the frame rather than stall the sampler
+      dropped_.fetch_add(1);
+      mutex_.give();
+      return;
+    }
+    block_timestamp_ = frame.timestamp;
+  }
+
+  std::memcpy(
+      open_block_ + sizeof(MatchBlockHeader) + frame_count_ * sizeof(MatchFrame),
+      &frame,
+      sizeof(frame));
+  frame_count_++;
+
+  if (frame_count_ == kMatchFramesPerBlock) { this->closeDataBlock(); }
+  mutex_.give();
+}
+
+void MatchRecorder::write()
+{
+  while (true)
+  {
+    // Oldest hand-off first so blocks stay in order on the card
+    Buffer* next = nullptr;
+    for (Buffer& buffer : buffers_)
+    {
+      if (!buffer.pending.load()) { continue; }
+      if (next == nullptr || static_cast<int32_t>(buffer.order - next->order) < 0)
+      {
+        next = &buffer;
+      }
+    }
+    if (next == nullptr) { break; }
+
+    fwrite(next->data.data(), kMatchBlockSize, next->blocks, file_);
+    fflush(file_);
+
+    next->blocks = 0;
+    next->pending.store(false);
+  }
+
+  if (closing_.load())
+  {
+    // stop() may have handed off another buffer since the loop above checked
+    mutex_.take();
+    if (!buffers_[0].pending.load() && !buffers_[1].pending.load())
+    {
+      if (file_ != nullptr) { fclose(file_); }
+      file_ = nullptr;
+      closing_.store(false);
+    }
+    mutex_.give();
+  }
+}
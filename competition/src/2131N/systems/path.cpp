@@ -0,0 +1,336 @@
+#include "2131N/systems/path.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+
+Path::Path(const asset& file, PathSettings settings) : settings_(settings)
+{
+  std::string_view text(reinterpret_cast<const char*>(file.buf), file.size);
+
+  // One "x, y, speed" point per line until the metadata starts
+  size_t line_start = 0;
+  while (line_start < text.size())
+  {
+    size_t line_end = text.find('\n', line_start);
+    if (line_end == std::string_view::npos) { line_end = text.size(); }
+
+    std::string_view line = text.substr(line_start, line_end - line_start);
+    line_start = line_end + 1;
+
+    if (line.rfind("endData", 0) == 0) { break; }
+    if (line.empty()) { continue; }
+
+    // strtof needs a terminated string, the lines are short
+    char buffer[64];
+    size_t length = std::min(line.size(), sizeof(buffer) - 1);
+    std::copy_n(line.data(), length, buffer);
+    buffer[length] = '\0';
+
+    char* cursor = buffer;
+    char* end = nullptr;
+    float values[3] = {0.0f, 0.0f, 0.0f};
+    size_t count = 0;
+    while (count < 3)
+    {
+      values[count] = std::strtof(cursor, &end);
+      if (end == cursor) { break; }
+      count++;
+      cursor = end;
+      while (*cursor == ',' || *cursor == ' ') { cursor++; }
+    }
+
+    if (count < 2) { continue; }
+    points_.push_back({values[0], values[1], count == 3 ? values[2] : 127.0f, 0.0f, 0.0f});
+  }
+
+  buildProfile();
+  buildGrid();
+}
+
+Path::Path(const std::vector<lemlib::Pose>& points, PathSettings settings) : settings_(settings)
+{
+  points_.reserve(points.size());
+  for (const lemlib::Pose& point : points)
+  {
+    points_.push_back({point.x, point.y, point.theta, 0.0f, 0.0f});
+  }
+
+  buildProfile();
+  buildGrid();
+}
+
+void Path::buildProfile()
+{
+  if (points_.empty()) { return; }
+
+  // Distance along the path
+  points_[0].distance = 0.0f;
+  for (size_t i = 1; i < points_.size(); i++)
+  {
+    float step = std::hypot(points_[i].x - points_[i - 1].x, points_[i].y - points_[i - 1].y);
+    points_[i].distance = points_[i - 1].distance + step;
+  }
+
+  // Curvature from the circle through each point and its neighbours
+  for (size_t i = 1; i + 1 < points_.size(); i++)
+  {
+    const PathPoint& a = points_[i - 1];
+    const PathPoint& b = points_[i];
+    const PathPoint& c = points_[i + 1];
+
+    float ab = std::hypot(b.x - a.x, b.y - a.y);
+    float bc = std::hypot(c.x - b.x, c.y - b.y);
+    float ca = std::hypot(a.x - c.x, a.y - c.y);
+    float cross = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+
+    float denominator = ab * bc * ca;
+    points_[i].curvature = denominator > 1e-6f ? 2.0f * std::fabs(cross) / denominator : 0.0f;
+  }
+
+  // Cap the file speed by what the chassis can corner at
+  for (PathPoint& point : points_)
+  {
+    float speed = point.speed / 127.0f * settings_.max_speed;
+    if (point.curvature > 1e-6f)
+    {
+      speed = std::min(speed, std::sqrt(settings_.max_lateral_acceleration / point.curvature));
+    }
+    point.speed = speed;
+  }
+
+  // Brake ahead of corners and down to the minimum speed at the end, the follower stops the
+  // robot once it is within tolerance (ramping to 0 would stall it short of the end)
+  points_.back().speed = settings_.min_speed;
+  for (size_t i = points_.size() - 1; i > 0; i--)
+  {
+    float distance = points_[i].distance - points_[i - 1].distance;
+    float reachable = std::sqrt(
+        points_[i].speed * points_[i].speed + 2.0f * settings_.max_deceleration * distance);
+    points_[i - 1].speed = std::min(points_[i - 1].speed, reachable);
+  }
+
+  // Never command less than the minimum speed
+  for (PathPoint& point : points_) { point.speed = std::max(point.speed, settings_.min_speed); }
+}
+
+void Path::buildGrid()
+{
+  if (points_.size() < 2) { return; }
+
+  float max_x = -std::numeric_limits<float>::infinity();
+  float max_y = -std::numeric_limits<float>::infinity();
+  grid_min_x_ = std::numeric_limits<float>::infinity();
+  grid_min_y_ = std::numeric_limits<float>::infinity();
+  for (const PathPoint& point : points_)
+  {
+    grid_min_x_ = std::min(grid_min_x_, point.x);
+    grid_min_y_ = std::min(grid_min_y_, point.y);
+    max_x = std::max(max_x, point.x);
+    max_y = std::max(max_y, point.y);
+  }
+
+  // Pad by a cell so robots slightly off the path still land in the grid
+  grid_min_x_ -= settings_.cell_size;
+  grid_min_y_ -= settings_.cell_size;
+  grid_columns_ = static_cast<size_t>((max_x - grid_min_x_) / settings_.cell_size) + 2;
+  grid_rows_ = static_cast<size_t>((max_y - grid_min_y_) / settings_.cell_size) + 2;
+
+  // Count, then fill (segments go in in order, so each cell stays sorted)
+  std::vector<uint32_t> counts(grid_columns_ * grid_rows_, 0);
+  auto for_each_cell = [this](size_t segment, auto&& function) {
+    const PathPoint& a = points_[segment];
+    const PathPoint& b = points_[segment + 1];
+    size_t column_a, row_a, column_b, row_b;
+    cellOf(std::min(a.x, b.x), std::min(a.y, b.y), column_a, row_a);
+    cellOf(std::max(a.x, b.x), std::max(a.y, b.y), column_b, row_b);
+    for (size_t row = row_a; row <= row_b; row++)
+    {
+      for (size_t column = column_a; column <= column_b; column++)
+      {
+        function(row * grid_columns_ + column);
+      }
+    }
+  };
+
+  for (size_t segment = 0; segment < getSegmentCount(); segment++)
+  {
+    for_each_cell(segment, [&counts](size_t cell) { counts[cell]++; });
+  }
+
+  cell_start_.assign(counts.size() + 1, 0);
+  for (size_t cell = 0; cell < counts.size(); cell++)
+  {
+    cell_start_[cell + 1] = cell_start_[cell] + counts[cell];
+  }
+
+  cell_segments_.resize(cell_start_.back());
+  std::vector<uint32_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+  for (size_t segment = 0; segment < getSegmentCount(); segment++)
+  {
+    for_each_cell(segment, [this, &fill, segment](size_t cell) {
+      cell_segments_[fill[cell]++] = static_cast<uint32_t>(segment);
+    });
+  }
+}
+
+void Path::cellOf(float x, float y, size_t& column, size_t& row) const
+{
+  float fx = std::floor((x - grid_min_x_) / settings_.cell_size);
+  float fy = std::floor((y - grid_min_y_) / settings_.cell_size);
+  column = static_cast<size_t>(std::clamp(fx, 0.0f, static_cast<float>(grid_columns_ - 1)));
+  row = static_cast<size_t>(std::clamp(fy, 0.0f, static_cast<float>(grid_rows_ - 1)));
+}
+
+lemlib::Pose Path::closestPoint(const lemlib::Pose& pose, size_t& cursor) const
+{
+  size_t segments = getSegmentCount();
+  if (segments == 0)
+  {
+    return points_.empty() ? pose : lemlib::Pose(points_[0].x, points_[0].y, 0.0f);
+  }
+
+  cursor = std::min(cursor, segments - 1);
+  const float window_end = points_[cursor].distance + settings_.search_distance;
+
+  float best_distance = std::numeric_limits<float>::infinity();
+  size_t best_segment = cursor;
+  float best_fraction = 0.0f;
+
+  auto check = [&](size_t segment) {
+    const PathPoint& a = points_[segment];
+    const PathPoint& b = points_[segment + 1];
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float length_squared = dx * dx + dy * dy;
+    float fraction =
+        length_squared > 1e-9f ? ((pose.x - a.x) * dx + (pose.y - a.y) * dy) / length_squared : 0;
+    fraction = std::clamp(fraction, 0.0f, 1.0f);
+
+    float distance = std::hypot(a.x + dx * fraction - pose.x, a.y + dy * fraction - pose.y);
+    if (distance < best_distance)
+    {
+      best_distance = distance;
+      best_segment = segment;
+      best_fraction = fraction;
+    }
+  };
+
+  // The cursor's own segment is always a candidate
+  check(cursor);
+
+  // Segments near the robot, but only ahead of the cursor and inside the window
+  size_t column, row;
+  cellOf(pose.x, pose.y, column, row);
+  for (size_t r = (row > 0 ? row - 1 : 0); r <= std::min(row + 1, grid_rows_ - 1); r++)
+  {
+    for (size_t c = (column > 0 ? column - 1 : 0); c <= std::min(column + 1, grid_columns_ - 1);
+         c++)
+    {
+      size_t cell = r * grid_columns_ + c;
+      auto first = cell_segments_.begin() + cell_start_[cell];
+      auto last = cell_segments_.begin() + cell_start_[cell + 1];
+      for (auto it = std::lower_bound(first, last, cursor);
+           it != last && points_[*it].distance <= window_end;
+           ++it)
+      {
+        check(*it);
+      }
+    }
+  }
+
+  cursor = best_segment;
+  const PathPoint& a = points_[best_segment];
+  const PathPoint& b = points_[best_segment + 1];
+  return lemlib::Pose(
+      a.x + (b.x - a.x) * best_fraction, a.y + (b.y - a.y) * best_fraction, best_fraction);
+}
+
+lemlib::Pose Path::lookaheadPoint(const lemlib::Pose& pose, float radius, size_t cursor) const
+{
+  size_t segments = getSegmentCount();
+  if (segments == 0) { return closestPoint(pose, cursor); }
+
+  // Past the end, aim at the last point
+  const PathPoint& last_point = points_.back();
+  if (std::hypot(last_point.x - pose.x, last_point.y - pose.y) <= radius)
+  {
+    return lemlib::Pose(last_point.x, last_point.y, 1.0f);
+  }
+
+  cursor = std::min(cursor, segments - 1);
+  const float window_end = points_[cursor].distance + radius + settings_.search_distance;
+
+  bool found = false;
+  size_t best_segment = cursor;
+  float best_fraction = 1.0f;
+
+  auto check = [&](size_t segment) {
+    const PathPoint& a = points_[segment];
+    const PathPoint& b = points_[segment + 1];
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float fx = a.x - pose.x;
+    float fy = a.y - pose.y;
+
+    // Solve |a + t(b - a) - pose| = radius, keeping the far root
+    float qa = dx * dx + dy * dy;
+    float qb = 2.0f * (fx * dx + fy * dy);
+    float qc = fx * fx + fy * fy - radius * radius;
+    float discriminant = qb * qb - 4.0f * qa * qc;
+    if (qa < 1e-9f || discriminant < 0.0f) { return; }
+
+    float fraction = (-qb + std::sqrt(discriminant)) / (2.0f * qa);
+    if (fraction < 0.0f || fraction > 1.0f) { return; }
+
+    if (!found || segment > best_segment || (segment == best_segment && fraction > best_fraction))
+    {
+      found = true;
+      best_segment = segment;
+      best_fraction = fraction;
+    }
+  };
+
+  // Cells the lookahead circle overlaps
+  size_t column_min, row_min, column_max, row_max;
+  cellOf(pose.x - radius, pose.y - radius, column_min, row_min);
+  cellOf(pose.x + radius, pose.y + radius, column_max, row_max);
+  for (size_t r = row_min; r <= row_max; r++)
+  {
+    for (size_t c = column_min; c <= column_max; c++)
+    {
+      size_t cell = r * grid_columns_ + c;
+      auto first = cell_segments_.begin() + cell_start_[cell];
+      auto last = cell_segments_.begin() + cell_start_[cell + 1];
+      for (auto it = std::lower_bound(first, last, cursor);
+           it != last && points_[*it].distance <= window_end;
+           ++it)
+      {
+        check(*it);
+      }
+    }
+  }
+
+  // No intersection (robot far off the path), aim for the end of the cursor's segment
+  const PathPoint& a = points_[best_segment];
+  const PathPoint& b = points_[best_segment + 1];
+  return lemlib::Pose(
+      a.x + (b.x - a.x) * best_fraction, a.y + (b.y - a.y) * best_fraction, best_fraction);
+}
+
+float Path::speedAt(size_t segment, float fraction) const
+{
+  if (points_.size() < 2) { return 0.0f; }
+  segment = std::min(segment, points_.size() - 2);
+  return points_[segment].speed + (points_[segment + 1].speed - points_[segment].speed) * fraction;
+}
+
+float Path::distanceAt(size_t segment, float fraction) const
+{
+  if (points_.size() < 2) { return 0.0f; }
+  segment = std::min(segment, points_.size() - 2);
+  return points_[segment].distance +
+         (points_[segment + 1].distance - points_[segment].distance) * fraction;
+}
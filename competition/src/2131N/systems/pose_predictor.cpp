@@ -0,0 +1,99 @@
+#include "2131N/systems/pose_predictor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lemlib/util.hpp"
+
+namespace
+{
+// Integration step for the forecasts (s)
+constexpr float kPredictionStep = 0.01f;
+
+// Longest forecast the predictor will integrate (s)
+constexpr float kMaxPredictionTime = 3.0f;
+}  // namespace
+
+PosePredictor::PosePredictor(PredictorSettings settings) : settings_(settings) {}
+
+void PosePredictor::update(
+    const lemlib::Pose& pose,
+    float velocity,
+    float angular_velocity,
+    float left_voltage,
+    float right_voltage)
+{
+  pose_ = pose;
+
+  // Split the chassis motion into side speeds (clockwise turns speed up the left side)
+  float turn_speed = angular_velocity * settings_.track_width / 2.0f;
+  left_velocity_ = velocity + turn_speed;
+  right_velocity_ = velocity - turn_speed;
+
+  // The speed each side settles at for the voltage it is being given
+  left_command_ = left_voltage / 12000.0f * settings_.max_speed;
+  right_command_ = right_voltage / 12000.0f * settings_.max_speed;
+}
+
+lemlib::Pose PosePredictor::predict(float time) const
+{
+  float x = pose_.x;
+  float y = pose_.y;
+  float theta = pose_.theta;
+  float left = left_velocity_;
+  float right = right_velocity_;
+
+  float remaining = std::clamp(time / 1000.0f, 0.0f, kMaxPredictionTime);
+  while (remaining > 0.0f)
+  {
+    float dt = std::min(kPredictionStep, remaining);
+
+    // Each side approaches its commanded speed like a first order system
+    float decay = std::exp(-dt / settings_.time_constant);
+    left = left_command_ + (left - left_command_) * decay;
+    right = right_command_ + (right - right_command_) * decay;
+
+    // Integrate along the arc using the heading halfway through the step
+    float velocity = (left + right) / 2.0f;
+    float angular_velocity = (left - right) / settings_.track_width;
+    float mid_heading = theta + angular_velocity * dt / 2.0f;
+    x += velocity * dt * std::sin(mid_heading);
+    y += velocity * dt * std::cos(mid_heading);
+    theta += angular_velocity * dt;
+
+    remaining -= dt;
+  }
+
+  return lemlib::Pose(x, y, lemlib::radToDeg(theta));
+}
+
+lemlib::Pose PosePredictor::predictStop() const
+{
+  float x = pose_.x;
+  float y = pose_.y;
+  float theta = pose_.theta;
+  float left = left_velocity_;
+  float right = right_velocity_;
+
+  // Brake both sides at the maximum deceleration until they stop
+  float speed_step = settings_.max_deceleration * kPredictionStep;
+  float elapsed = 0.0f;
+  while ((left != 0.0f || right != 0.0f) && elapsed < kMaxPredictionTime)
+  {
+    left = std::fabs(left) <= speed_step ? 0.0f : left - std::copysign(speed_step, left);
+    right = std::fabs(right) <= speed_step ? 0.0f : right - std::copysign(speed_step, right);
+
+    float velocity = (left + right) / 2.0f;
+    float angular_velocity = (left - right) / settings_.track_width;
+    float mid_heading = theta + angular_velocity * kPredictionStep / 2.0f;
+    x += velocity * kPredictionStep * std::sin(mid_heading);
+    y += velocity * kPredictionStep * std::cos(mid_heading);
+    theta += angular_velocity * kPredictionStep;
+
+    elapsed += kPredictionStep;
+  }
+
+  return lemlib::Pose(x, y, lemlib::radToDeg(theta));
+}
+
+const PredictorSettings& PosePredictor::getSettings() const { return settings_; }
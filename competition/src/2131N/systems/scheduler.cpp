@@ -0,0 +1,114 @@
+#include "2131N/systems/scheduler.hpp"
+
+#include <algorithm>
+#include <utility>
+
+bool Scheduler::addJob(
+    const char* name, uint32_t period, uint32_t deadline, std::function<void()> step)
+{
+  if (started_ || job_count_ == kMaxJobs || period == 0) { return false; }
+
+  Job& job = jobs_[job_count_++];
+  job.name = name;
+  job.period = period;
+  job.deadline = deadline == 0 ? period : deadline;
+  job.step = std::move(step);
+  return true;
+}
+
+void Scheduler::start()
+{
+  if (started_) { return; }
+  started_ = true;
+
+  // Rate monotonic: one priority level per distinct period, shortest period highest
+  std::array<size_t, kMaxJobs> order;
+  for (size_t i = 0; i < job_count_; i++) { order[i] = i; }
+  std::stable_sort(order.begin(), order.begin() + job_count_, [this](size_t a, size_t b) {
+    return jobs_[a].period < jobs_[b].period;
+  });
+
+  uint32_t priority = kHighestPriority;
+  for (size_t i = 0; i < job_count_; i++)
+  {
+    if (i > 0 && jobs_[order[i]].period != jobs_[order[i - 1]].period &&
+        priority > kLowestPriority)
+    {
+      priority--;
+    }
+    jobs_[order[i]].priority = priority;
+  }
+
+  for (size_t i = 0; i < job_count_; i++)
+  {
+    Job& job = jobs_[i];
+    job.task.emplace(
+        [&job]() { Scheduler::run(job); }, job.priority, TASK_STACK_DEPTH_DEFAULT, job.name);
+  }
+}
+
+void Scheduler::run(Job& job)
+{
+  uint32_t release = pros::millis();
+  uint64_t window_start = pros::micros();
+  uint64_t busy = 0;
+
+  while (true)
+  {
+    uint64_t start = pros::micros();
+    job.step();
+    uint64_t runtime = pros::micros() - start;
+
+    job.runs.fetch_add(1);
+    job.max_runtime.store(std::max<uint32_t>(job.max_runtime.load(), runtime));
+
+    uint32_t now = pros::millis();
+    if (now - release > job.deadline) { job.overruns.fetch_add(1); }
+
+    // Running late enough to miss the next release, start the schedule again instead of
+    // bursting through the missed ones
+    if (now - release >= job.period) { release = now; }
+
+    // Utilization over the last window
+    busy += runtime;
+    uint64_t window = pros::micros() - window_start;
+    if (window >= kWindow)
+    {
+      job.utilization.store(static_cast<float>(busy) / window);
+      window_start += window;
+      busy = 0;
+    }
+
+    pros::Task::delay_until(&release, job.period);
+  }
+}
+
+JobStats Scheduler::getStats(size_t index) const
+{
+  if (index >= job_count_) { return {}; }
+
+  const Job& job = jobs_[index];
+  return {
+      job.name,
+      job.period,
+      job.deadline,
+      job.priority,
+      job.runs.load(),
+      job.overruns.load(),
+      job.max_runtime.load(),
+      job.utilization.load()};
+}
+
+float Scheduler::getUtilization() const
+{
+  float utilization = 0.0f;
+  for (size_t i = 0; i < job_count_; i++) { utilization += jobs_[i].utilization.load(); }
+  return utilization;
+}
+
+uint32_t Scheduler::getOverruns() const
+{
+  uint32_t overruns = 0;
+  for (size_t i = 0; i < job_count_; i++) { overruns += jobs_[i].overruns.load(); }
+  return overruns;
+}
@@ -0,0 +1,134 @@
+#include "2131N/systems/serial_telemetry.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "lemlib/chassis/odom.hpp"
+#include "pros/apix.h"
+
+SerialTelemetry::SerialTelemetry(
+    Chassis* chassis,
+    std::function<void(SerialParticleCloud&)> particles,
+    uint32_t period,
+    uint32_t particle_period)
+    : chassis_(chassis),
+      particles_(std::move(particles)),
+      period_(period),
+      particle_period_(particle_period),
+      task_(
+          [this]() {
+            uint32_t last_wake = pros::millis();
+            while (true)
+            {
+              this->update();
+              pros::Task::delay_until(&last_wake, period_);
+            }
+          },
+          TASK_PRIORITY_MIN + 1,
+          TASK_STACK_DEPTH_DEFAULT,
+          "Serial Telemetry")
+{
+}
+
+void SerialTelemetry::start()
+{
+  if (running_.load()) { return; }
+
+  pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+  pros::c::fdctl(STDOUT_FILENO, SERCTL_NOBLKWRITE, nullptr);
+
+  // Start from a key frame so the receiver can decode straight away
+  poses_sent_ = 0;
+  running_.store(true);
+}
+
+void SerialTelemetry::stop()
+{
+  if (!running_.exchange(false)) { return; }
+
+  // Let a write in progress finish before stdout goes back to the terminal
+  pros::delay(period_);
+  pros::c::fdctl(STDOUT_FILENO, SERCTL_BLKWRITE, nullptr);
+  pros::c::serctl(SERCTL_ENABLE_COBS, nullptr);
+}
+
+void SerialTelemetry::send(size_t length)
+{
+  size_t size = serialFrame(packet_.data(), length, frame_.data());
+
+  // Non-blocking, a partial write is caught by the receiver's checksum
+  ssize_t written = write(STDOUT_FILENO, frame_.data(), size);
+  if (written != static_cast<ssize_t>(size)) { dropped_.fetch_add(1); }
+}
+
+void SerialTelemetry::sendPose()
+{
+  lemlib::Pose pose = chassis_->getPose();
+  SerialPose next{
+      static_cast<int32_t>(pros::millis()),
+      serialQuantize(pose.x, kSerialPositionScale),
+      serialQuantize(pose.y, kSerialPositionScale),
+      serialQuantize(pose.theta, kSerialHeadingScale),
+      serialQuantize(lemlib::getLocalSpeed().y, kSerialVelocityScale),
+      serialQuantize(lemlib::getSpeed(true).theta, kSerialAngularScale)};
+
+  bool key = poses_sent_++ % kSerialKeyInterval == 0;
+
+  uint8_t* out = packet_.data();
+  *out++ = static_cast<uint8_t>(SerialPacketType::POSE) | (key ? kSerialKeyFrame : 0);
+  *out++ = pose_sequence_++;
+  serialPutPose(out, next, last_pose_, key);
+  last_pose_ = next;
+
+  this->send(out - packet_.data());
+}
+
+void SerialTelemetry::sendParticles()
+{
+  cloud_.count = 0;
+  particles_(cloud_);
+  size_t count = std::min(cloud_.count, SerialParticleCloud::kMaxParticles);
+
+  // Neighbours in x are close together, so each step is only a byte or two
+  std::sort(
+      cloud_.particles.begin(),
+      cloud_.particles.begin() + count,
+      [](const Point& a, const Point& b) { return a.x < b.x; });
+
+  uint8_t* out = packet_.data();
+  *out++ = static_cast<uint8_t>(SerialPacketType::PARTICLES) | kSerialKeyFrame;
+  *out++ = particle_sequence_++;
+  putVarint(out, pros::millis());
+  putSignedVarint(out, serialQuantize(cloud_.estimate.x, kSerialPositionScale));
+  putSignedVarint(out, serialQuantize(cloud_.estimate.y, kSerialPositionScale));
+  putVarint(out, std::max<int32_t>(serialQuantize(cloud_.variance, kSerialVarianceScale), 0));
+  putVarint(out, count);
+
+  int32_t last_x = 0;
+  int32_t last_y = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    int32_t x = serialQuantize(cloud_.particles[i].x, kSerialParticleScale);
+    int32_t y = serialQuantize(cloud_.particles[i].y, kSerialParticleScale);
+    putSignedVarint(out, x - last_x);
+    putSignedVarint(out, y - last_y);
+    last_x = x;
+    last_y = y;
+  }
+
+  this->send(out - packet_.data());
+}
+
+void SerialTelemetry::update()
+{
+  if (!running_.load()) { return; }
+
+  this->sendPose();
+
+  if (particles_ && pros::millis() - last_particles_ >= particle_period_)
+  {
+    last_particles_ = pros::millis();
+    this->sendParticles();
+  }
+}
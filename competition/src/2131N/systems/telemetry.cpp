@@ -0,0 +1,206 @@
+#include "2131N/systems/telemetry.hpp"
+
+#include <string_view>
+
+#include "lemlib/logger/baseSink.hpp"
+#include "pros/misc.hpp"
+
+Telemetry telemetry;
+
+Telemetry::Telemetry(uint32_t period)
+    : period_(period),
+      drain_task_(
+          [this]() { this->run(); },
+          TASK_PRIORITY_MIN + 1,
+          TASK_STACK_DEPTH_DEFAULT,
+          "Telemetry Drain")
+{
+}
+
+bool Telemetry::open(TelemetrySink sink, const char* path)
+{
+  this->close();
+
+  sink_mutex_.take();
+  switch (sink)
+  {
+    case TelemetrySink::NONE: break;
+    case TelemetrySink::SERIAL: file_ = stdout; break;
+    case TelemetrySink::SD:
+    {
+      if (!pros::usd::is_installed()) { break; }
+      if (path != nullptr)
+      {
+        file_ = fopen(path, "wb");
+        break;
+      }
+
+      // Never overwrite the log of an earlier boot
+      char next_path[32];
+      for (int i = 0; i < 1000 && file_ == nullptr; i++)
+      {
+        snprintf(next_path, sizeof(next_path), "/usd/telemetry_%03d.bin", i);
+        FILE* existing = fopen(next_path, "rb");
+        if (existing != nullptr)
+        {
+          fclose(existing);
+          continue;
+        }
+        file_ = fopen(next_path, "wb");
+        if (file_ == nullptr) { break; }
+      }
+      break;
+    }
+  }
+
+  bool opened = sink == TelemetrySink::NONE || file_ != nullptr;
+  if (file_ != nullptr)
+  {
+    TelemetryHeader header;
+    fwrite(&header, sizeof(header), 1, file_);
+  }
+
+  // A new stream needs every format definition again
+  formats_sent_.fill(false);
+
+  sink_ = opened ? sink : TelemetrySink::NONE;
+  enabled_.store(opened);
+  sink_mutex_.give();
+
+  return opened;
+}
+
+void Telemetry::close()
+{
+  enabled_.store(false);
+
+  sink_mutex_.take();
+  if (file_ != nullptr)
+  {
+    this->drain();
+    if (sink_ == TelemetrySink::SD) { fclose(file_); }
+    else { fflush(file_); }
+  }
+  file_ = nullptr;
+  sink_ = TelemetrySink::NONE;
+  sink_mutex_.give();
+}
+
+void Telemetry::setMessageSink(std::shared_ptr<lemlib::BaseSink> sink)
+{
+  sink_mutex_.take();
+  message_sink_ = std::move(sink);
+  sink_mutex_.give();
+}
+
+uint32_t Telemetry::getDropped() const
+{
+  uint32_t dropped = messages_.getDropped();
+  for (const auto& ring : rings_) { dropped += ring.getDropped(); }
+  return dropped;
+}
+
+void Telemetry::drain()
+{
+  TelemetryRecord record;
+
+  for (auto& ring : rings_)
+  {
+    while (ring.pop(record)) { this->emit(record); }
+  }
+
+  while (messages_.pop(record)) { this->drainMessage(record); }
+
+  this->flushBatch();
+}
+
+void Telemetry::drainMessage(const TelemetryRecord& record)
+{
+  TelemetryMessage message;
+  std::memcpy(&message, record.payload, sizeof(message));
+
+  const DeferredFormat* format = deferred_formats.get(message.format);
+  if (format == nullptr) { return; }
+
+  if (file_ != nullptr)
+  {
+    // The host can only format a message once it has the definition
+    if (!formats_sent_[message.format])
+    {
+      size_t signature_length = std::strlen(format->signature) + 1;
+      size_t length = signature_length + std::strlen(format->format) + 1;
+
+      TelemetryFormatChunk chunk;
+      chunk.format = message.format;
+      for (size_t offset = 0; offset < length; offset += sizeof(chunk.text))
+      {
+        chunk.offset = offset;
+        for (size_t i = 0; i < sizeof(chunk.text); i++)
+        {
+          size_t position = offset + i;
+          if (position < signature_length) { chunk.text[i] = format->signature[position]; }
+          else if (position < length) { chunk.text[i] = format->format[position - signature_length]; }
+          else { chunk.text[i] = '\0'; }
+        }
+
+        TelemetryRecord definition;
+        definition.timestamp = record.timestamp;
+        definition.channel = static_cast<uint8_t>(TelemetryChannel::FORMAT);
+        definition.size = sizeof(chunk);
+        definition.sequence = 0;
+        std::memcpy(definition.payload, &chunk, sizeof(chunk));
+        this->emit(definition);
+      }
+
+      formats_sent_[message.format] = true;
+    }
+
+    this->emit(record);
+  }
+
+  // Formatting only happens here, well away from the task that logged the message
+  if (message_sink_ != nullptr)
+  {
+    char text[128];
+    formatDeferred(format->format, format->signature, message.args, message.size, text, sizeof(text));
+    message_sink_->log(static_cast<lemlib::Level>(message.level), "{}", std::string_view(text));
+  }
+}
+
+void Telemetry::emit(const TelemetryRecord& record)
+{
+  batch_[batch_count_++] = record;
+  if (batch_count_ == kBatchSize) { this->flushBatch(); }
+}
+
+void Telemetry::flushBatch()
+{
+  if (batch_count_ > 0 && file_ != nullptr)
+  {
+    fwrite(batch_.data(), sizeof(TelemetryRecord), batch_count_, file_);
+  }
+  batch_count_ = 0;
+}
+
+void Telemetry::run()
+{
+  uint32_t last_wake = pros::millis();
+  uint32_t last_flush = last_wake;
+
+  while (true)
+  {
+    sink_mutex_.take();
+    this->drain();
+
+    // Serial should show up live, the SD card is flushed less often since every flush is slow
+    uint32_t flush_period = sink_ == TelemetrySink::SD ? 1000 : 0;
+    if (file_ != nullptr && pros::millis() - last_flush >= flush_period)
+    {
+      fflush(file_);
+      last_flush = pros::millis();
+    }
+    sink_mutex_.give();
+
+    pros::Task::delay_until(&last_wake, period_);
+  }
+}
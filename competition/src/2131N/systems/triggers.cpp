@@ -0,0 +1,177 @@
+#include "2131N/systems/triggers.hpp"
+
+#include <cmath>
+
+#include "lemlib/util.hpp"
+
+TriggerCondition TriggerCondition::traveled(float distance)
+{
+  TriggerCondition condition{Type::TRAVELED};
+  condition.value = distance;
+  return condition;
+}
+
+TriggerCondition TriggerCondition::near(float x, float y, float radius, float lead_time)
+{
+  TriggerCondition condition{Type::NEAR};
+  condition.x = x;
+  condition.y = y;
+  condition.value = radius;
+  condition.lead_time = lead_time;
+  return condition;
+}
+
+TriggerCondition TriggerCondition::heading(float theta, float epsilon)
+{
+  TriggerCondition condition{Type::HEADING};
+  condition.theta = theta;
+  condition.value = epsilon;
+  return condition;
+}
+
+TriggerCondition TriggerCondition::ballDetected() { return TriggerCondition{Type::BALL_DETECTED}; }
+
+TriggerEngine::TriggerEngine(Chassis* chassis, Intake* intake, uint32_t period)
+    : chassis_(chassis),
+      intake_(intake),
+      period_(period),
+      task_(
+          [this]() { this->run(); },
+          TASK_PRIORITY_DEFAULT + 2,
+          TASK_STACK_DEPTH_DEFAULT,
+          "Trigger Engine")
+{
+}
+
+bool TriggerEngine::schedule(
+    TriggerCondition condition, std::function<void()> action, int timeout, bool fire_on_expire)
+{
+  mutex_.take();
+
+  // Use the first free slot
+  for (Slot& slot : slots_)
+  {
+    if (slot.armed) { continue; }
+
+    slot.condition = condition;
+    slot.action = std::move(action);
+    slot.expiry = pros::millis() + timeout;
+    slot.fire_on_expire = fire_on_expire;
+    slot.armed = true;
+
+    mutex_.give();
+    return true;
+  }
+
+  mutex_.give();
+  return false;
+}
+
+void TriggerEngine::clear()
+{
+  mutex_.take();
+  for (Slot& slot : slots_) { slot.armed = false; }
+  mutex_.give();
+}
+
+void TriggerEngine::expire()
+{
+  std::array<std::function<void()>, kMaxTriggers> fallbacks;
+  size_t fallback_count = 0;
+
+  mutex_.take();
+  for (Slot& slot : slots_)
+  {
+    if (slot.armed && slot.fire_on_expire) { fallbacks[fallback_count++] = std::move(slot.action); }
+    slot.armed = false;
+  }
+  mutex_.give();
+
+  for (size_t i = 0; i < fallback_count; i++) { fallbacks[i](); }
+}
+
+size_t TriggerEngine::pending()
+{
+  mutex_.take();
+  size_t armed = 0;
+  for (const Slot& slot : slots_) { armed += slot.armed ? 1 : 0; }
+  mutex_.give();
+
+  return armed;
+}
+
+bool TriggerEngine::waitUntilIdle(int timeout)
+{
+  uint32_t start = pros::millis();
+  while (this->pending() > 0)
+  {
+    if (pros::millis() - start >= static_cast<uint32_t>(timeout)) { return false; }
+    pros::delay(period_);
+  }
+
+  return true;
+}
+
+bool TriggerEngine::waitFor(TriggerCondition condition, int timeout)
+{
+  uint32_t start = pros::millis();
+  while (!this->evaluate(condition))
+  {
+    if (pros::millis() - start >= static_cast<uint32_t>(timeout)) { return false; }
+    pros::delay(period_);
+  }
+
+  return true;
+}
+
+bool TriggerEngine::evaluate(const TriggerCondition& condition)
+{
+  switch (condition.type)
+  {
+    case TriggerCondition::Type::TRAVELED:
+      return chassis_->getDistanceTraveled() >= condition.value;
+    case TriggerCondition::Type::NEAR:
+      return chassis_->getPredictedPose(condition.lead_time)
+                 .distance(lemlib::Pose(condition.x, condition.y)) <= condition.value;
+    case TriggerCondition::Type::HEADING:
+      return std::fabs(lemlib::angleError(condition.theta, chassis_->getPose().theta, false)) <=
+             condition.value;
+    case TriggerCondition::Type::BALL_DETECTED:
+      return intake_->isBallDetected();
+  }
+
+  return false;
+}
+
+void TriggerEngine::run()
+{
+  uint32_t last_wake = pros::millis();
+
+  while (true)
+  {
+    // Actions are copied out so they run without holding the slots
+    std::array<std::function<void()>, kMaxTriggers> fired;
+    size_t fired_count = 0;
+
+    mutex_.take();
+    uint32_t now = pros::millis();
+    for (Slot& slot : slots_)
+    {
+      if (!slot.armed) { continue; }
+
+      bool met = this->evaluate(slot.condition);
+      bool expired = static_cast<int32_t>(now - slot.expiry) >= 0;
+      if (!met && !expired) { continue; }
+
+      if (met || slot.fire_on_expire) { fired[fired_count++] = std::move(slot.action); }
+
+      slot.armed = false;
+    }
+    mutex_.give();
+
+    for (size_t i = 0; i < fired_count; i++) { fired[i](); }
+
+    // Fixed rate, independent of how long the actions took
+    pros::Task::delay_until(&last_wake, period_);
+  }
+}
@@ -0,0 +1,221 @@
+#include "2131N/ui/field_view.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "pros/rtos.hpp"
+
+// Canvas pixels, RGB565 keeps it to 115KB
+alignas(64) static uint8_t canvas_buffer[LV_DRAW_BUF_SIZE(
+    FieldView::kFieldPixels, FieldView::kFieldPixels, LV_COLOR_FORMAT_RGB565)];
+
+FieldView::FieldView(
+    Chassis* chassis,
+    Screen* screen,
+    std::function<void(MclSnapshot&)> mcl_snapshot,
+    uint32_t period)
+    : chassis_(chassis), screen_(screen), mcl_snapshot_(std::move(mcl_snapshot)), period_(period)
+{
+}
+
+void FieldView::create()
+{
+  view_ = lv_obj_create(nullptr);
+  lv_obj_set_style_bg_color(view_, lv_color_black(), LV_PART_MAIN);
+  lv_obj_add_event_cb(view_, &FieldView::onClick, LV_EVENT_CLICKED, this);
+
+  canvas_ = lv_canvas_create(view_);
+  lv_canvas_set_buffer(
+      canvas_, canvas_buffer, kFieldPixels, kFieldPixels, LV_COLOR_FORMAT_RGB565);
+  lv_obj_set_pos(canvas_, 0, 0);
+
+  label_ = lv_label_create(view_);
+  lv_obj_set_pos(label_, kFieldPixels + 10, 10);
+  lv_obj_set_style_text_color(label_, lv_color_white(), LV_PART_MAIN);
+  lv_label_set_text(label_, "");
+
+  // Drawing happens in LVGL's thread too, so nothing here ever touches LVGL from the MCL task
+  timer_ = lv_timer_create(&FieldView::onTimer, period_, this);
+  lv_timer_pause(timer_);
+}
+
+void FieldView::show()
+{
+  // LVGL has no lock in this build, so the view is only ever touched from LVGL's own thread
+  lv_async_call(&FieldView::onShow, this);
+}
+
+void FieldView::hide() { lv_async_call(&FieldView::onHide, this); }
+
+void FieldView::showView()
+{
+  if (visible_.load()) { return; }
+  if (view_ == nullptr) { this->create(); }
+
+  // Stop the auto selector drawing over the view
+  screen_->setPaused(true);
+
+  visible_.store(true);
+  previous_ = lv_screen_active();
+  lv_screen_load(view_);
+  lv_timer_resume(timer_);
+  lv_timer_ready(timer_);
+}
+
+void FieldView::hideView()
+{
+  if (!visible_.load()) { return; }
+
+  visible_.store(false);
+  lv_timer_pause(timer_);
+  if (previous_ != nullptr) { lv_screen_load(previous_); }
+
+  // The selector redraws everything once LVGL has cleared the view
+  screen_->setPaused(false);
+}
+
+lv_point_precise_t FieldView::toCanvas(const Point& point)
+{
+  constexpr double scale = kFieldPixels / kFieldInches;
+
+  // Screen y grows downwards
+  return {
+      static_cast<lv_value_precise_t>(point.x * scale),
+      static_cast<lv_value_precise_t>((kFieldInches - point.y) * scale)};
+}
+
+void FieldView::draw()
+{
+  mcl_snapshot_(snapshot_);
+  lemlib::Pose pose = chassis_->getPose();
+
+  lv_canvas_fill_bg(canvas_, lv_color_hex(0x3A3A3A), LV_OPA_COVER);
+
+  lv_layer_t layer;
+  lv_canvas_init_layer(canvas_, &layer);
+
+  lv_draw_line_dsc_t line;
+  lv_draw_line_dsc_init(&line);
+  line.width = 1;
+
+  // Tile seams every 24"
+  line.color = lv_color_hex(0x606060);
+  for (int tile = 1; tile < 6; tile++)
+  {
+    double seam = tile * 24.0;
+    line.p1 = toCanvas({seam, 0});
+    line.p2 = toCanvas({seam, kFieldInches});
+    lv_draw_line(&layer, &line);
+    line.p1 = toCanvas({0, seam});
+    line.p2 = toCanvas({kFieldInches, seam});
+    lv_draw_line(&layer, &line);
+  }
+
+  // Particle cloud, one short line per particle so they are visible at this scale
+  line.color = lv_color_hex(0xFFD000);
+  line.width = 2;
+  for (size_t i = 0; i < snapshot_.count; i++)
+  {
+    line.p1 = toCanvas(snapshot_.particles[i]);
+    line.p2 = {line.p1.x + 1, line.p1.y};
+    lv_draw_line(&layer, &line);
+  }
+
+  // 2 sigma covariance ellipse around the MCL estimate
+  double xx = snapshot_.covariance_xx;
+  double xy = snapshot_.covariance_xy;
+  double yy = snapshot_.covariance_yy;
+  double mean = (xx + yy) / 2.0;
+  double spread = std::sqrt((xx - yy) * (xx - yy) / 4.0 + xy * xy);
+  double major = 2.0 * std::sqrt(std::max(mean + spread, 0.0));
+  double minor = 2.0 * std::sqrt(std::max(mean - spread, 0.0));
+  double angle = 0.5 * std::atan2(2.0 * xy, xx - yy);
+  major = std::min(major, kFieldInches);
+  minor = std::min(minor, kFieldInches);
+
+  line.color = lv_color_hex(0x00E0FF);
+  line.width = 1;
+  constexpr int segments = 32;
+  Point last;
+  for (int i = 0; i <= segments; i++)
+  {
+    double t = 2.0 * M_PI * i / segments;
+    double u = major * std::cos(t);
+    double v = minor * std::sin(t);
+    Point next{
+        snapshot_.estimate.x + u * std::cos(angle) - v * std::sin(angle),
+        snapshot_.estimate.y + u * std::sin(angle) + v * std::cos(angle)};
+    if (i > 0)
+    {
+      line.p1 = toCanvas(last);
+      line.p2 = toCanvas(next);
+      lv_draw_line(&layer, &line);
+    }
+    last = next;
+  }
+
+  // MCL estimate as a cross
+  line.width = 2;
+  line.p1 = toCanvas({snapshot_.estimate.x - 3, snapshot_.estimate.y});
+  line.p2 = toCanvas({snapshot_.estimate.x + 3, snapshot_.estimate.y});
+  lv_draw_line(&layer, &line);
+  line.p1 = toCanvas({snapshot_.estimate.x, snapshot_.estimate.y - 3});
+  line.p2 = toCanvas({snapshot_.estimate.x, snapshot_.estimate.y + 3});
+  lv_draw_line(&layer, &line);
+
+  // Odometry pose, a square with a line showing the heading (clockwise from +y)
+  double heading = pose.theta * M_PI / 180.0;
+  lv_draw_rect_dsc_t robot;
+  lv_draw_rect_dsc_init(&robot);
+  robot.bg_color = lv_color_hex(0xFF3030);
+  lv_point_precise_t center = toCanvas({pose.x, pose.y});
+  lv_area_t area = {
+      static_cast<int32_t>(center.x) - 4,
+      static_cast<int32_t>(center.y) - 4,
+      static_cast<int32_t>(center.x) + 4,
+      static_cast<int32_t>(center.y) + 4};
+  lv_draw_rect(&layer, &robot, &area);
+
+  line.color = lv_color_hex(0xFF3030);
+  line.p1 = center;
+  line.p2 = toCanvas({pose.x + 10.0 * std::sin(heading), pose.y + 10.0 * std::cos(heading)});
+  lv_draw_line(&layer, &line);
+
+  lv_canvas_finish_layer(canvas_, &layer);
+
+  char text[192];
+  snprintf(
+      text,
+      sizeof(text),
+      "Odometry\n"
+      "X: %.1f  Y: %.1f\n"
+      "Heading: %.1f\n\n"
+      "MCL\n"
+      "X: %.1f  Y: %.1f\n"
+      "Variance: %.2f\n"
+      "Updated %lu ms ago\n\n"
+      "Tap to go back",
+      pose.x,
+      pose.y,
+      pose.theta,
+      snapshot_.estimate.x,
+      snapshot_.estimate.y,
+      snapshot_.variance,
+      static_cast<unsigned long>(pros::millis() - snapshot_.timestamp));
+  lv_label_set_text(label_, text);
+}
+
+void FieldView::onTimer(lv_timer_t* timer)
+{
+  static_cast<FieldView*>(lv_timer_get_user_data(timer))->draw();
+}
+
+void FieldView::onClick(lv_event_t* event)
+{
+  static_cast<FieldView*>(lv_event_get_user_data(event))->hideView();
+}
+
+void FieldView::onShow(void* view) { static_cast<FieldView*>(view)->showView(); }
+
+void FieldView::onHide(void* view) { static_cast<FieldView*>(view)->hideView(); }
@@ -1,8 +1,9 @@
 #include "2131N/ui/screen.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
-#include "2131N/utils/split.hpp"
 #include "pros/screen.hpp"
 
 RectButton::RectButton(
@@ -26,82 +27,117 @@ RectButton::RectButton(
       boarder_color_(boarderColor),
       fill_color_(fillColor),
       text_format_(text_format),
-      text_(text),
       x_padding_(x_padding),
       y_padding_(y_padding),
       callback_(callback)
 {
+  this->setText(text);
 }
 
 void RectButton::setText(const std::string& newText)
 {
-  // Update the text
-  text_ = newText;
-
-  // If the text isn't empty
-  if (!text_.empty())
+  // Only split the text into lines when it changes
+  if (newText != text_)
   {
-    // Set the text color and text background
-    pros::screen::set_eraser(fill_color_);
-    pros::screen::set_pen(boarder_color_);
-
-    // Split string newlines
-    auto tokens = splitStr(text_, '\n');
-
-    // Calculate character line height
-    int16_t line_height;
-    switch (text_format_)
-    {
-      case pros::text_format_e_t::E_TEXT_SMALL:
-        line_height = 10;
-        break;
-      case pros::text_format_e_t::E_TEXT_MEDIUM:
-        line_height = 20;
-        break;
-      case pros::text_format_e_t::E_TEXT_LARGE:
-        line_height = 30;
-        break;
-      default:
-        line_height = 20;
-    }
+    text_ = newText;
+    text_line_count_ = 0;
 
-    // For each token print a string on the brain
-    for (size_t i = 0; i < tokens.size(); i++)
+    // Split on newlines (skipping empty ones), anything past the end of a line is cut off
+    size_t length = 0;
+    for (size_t i = 0; i <= text_.size() && text_line_count_ < kMaxLines; i++)
     {
-      pros::screen::print(
-          text_format_,
-          x_ + x_padding_,
-          y_ + y_padding_ + line_height * i,
-          "%s",
-          tokens[i].c_str());
+      if (i == text_.size() || text_[i] == '\n')
+      {
+        if (length > 0)
+        {
+          lines_[text_line_count_++][length] = '\0';
+          length = 0;
+        }
+        continue;
+      }
+      if (length < kLineLength - 1) { lines_[text_line_count_][length++] = text_[i]; }
     }
   }
+
+  // Lines appended last frame are added again by the caller
+  line_count_ = text_line_count_;
+}
+
+char* RectButton::appendLine()
+{
+  if (line_count_ == kMaxLines) { return nullptr; }
+  return lines_[line_count_++].data();
 }
 
 void RectButton::setFillColor(pros::Color newFillColor)
 {
+  // Only a different color needs the whole button redrawn
+  if (newFillColor == fill_color_) { return; }
+
   // Set the new fill color
   fill_color_ = newFillColor;
 
   // Update the button
-  ignore_press_ = true;
+  dirty_ = true;
   update();
 }
 
+void RectButton::invalidate() { dirty_ = true; }
+
+void RectButton::attach(TouchDispatcher& dispatcher)
+{
+  dispatcher.addRegion(
+      x_,
+      y_,
+      width_,
+      height_,
+      [this](const TouchEvent&) {
+        pressed_ = true;
+        callback_();
+      },
+      [this](const TouchEvent&) { pressed_ = false; });
+}
+
 bool RectButton::getPressed()
 {
   // Return if the button has been pressed
   return pressed_;
 }
 
+int16_t RectButton::getLineHeight() const
+{
+  // Calculate character line height
+  switch (text_format_)
+  {
+    case pros::text_format_e_t::E_TEXT_SMALL:
+      return 10;
+    case pros::text_format_e_t::E_TEXT_MEDIUM:
+      return 20;
+    case pros::text_format_e_t::E_TEXT_LARGE:
+      return 30;
+    default:
+      return 20;
+  }
+}
+
+void RectButton::eraseLine(size_t line)
+{
+  int16_t top = y_ + y_padding_ + getLineHeight() * line;
+  int16_t bottom = std::min<int16_t>(top + getLineHeight() - 1, y_ + height_ - boarder_width_);
+
+  // Line is below the bottom of the button
+  if (top > bottom) { return; }
+
+  pros::screen::set_eraser(fill_color_);
+  pros::screen::erase_rect(x_ + boarder_width_, top, x_ + width_ - boarder_width_, bottom);
+}
+
 void RectButton::update()
 {
-  // If the screen has been pressed or ignore press has been set
-  if (pros::screen::touch_status().touch_status == pros::last_touch_e_t::E_TOUCH_PRESSED ||
-      ignore_press_)
+  // Redraw the whole button (background, boarder and all text)
+  if (dirty_)
   {
-    // Turn ignore press off (we updating)
-    ignore_press_ = false;
+    dirty_ = false;
 
     // Set the fill and boarder color
     pros::screen::set_eraser(fill_color_);
@@ -116,17 +152,39 @@ void RectButton::update()
       pros::screen::draw_rect(x_ + i, y_ + i, x_ + width_ - i, y_ + height_ - i);
     }
 
-    // if the text isn't empty then draw the text
-    if (!text_.empty()) { this->setText(text_); }
+    // Nothing of the old text is left on the screen
+    rendered_line_count_ = 0;
+  }
+
+  // Draw only the lines that changed since they were last drawn
+  size_t line_count = std::max(line_count_, rendered_line_count_);
+  for (size_t i = 0; i < line_count; i++)
+  {
+    bool on_screen = i < rendered_line_count_;
+    bool wanted = i < line_count_;
+    if (on_screen && wanted && std::strcmp(rendered_lines_[i].data(), lines_[i].data()) == 0)
+    {
+      continue;
+    }
 
-    // Set pressed to whether or not the touch status (x, y) is within the rectangle
-    pressed_ =
-        pros::screen::touch_status().x >= x_ && pros::screen::touch_status().x <= x_ + width_ &&
-        pros::screen::touch_status().y >= y_ && pros::screen::touch_status().y <= y_ + height_;
+    // Clear what was there (a shorter line would leave the end of the old one behind)
+    if (on_screen) { eraseLine(i); }
 
-    // if pressed then call the callback
-    if (pressed_) { callback_(); }
+    if (wanted)
+    {
+      // Set the text color and text background
+      pros::screen::set_eraser(fill_color_);
+      pros::screen::set_pen(boarder_color_);
+      pros::screen::print(
+          text_format_,
+          x_ + x_padding_,
+          y_ + y_padding_ + getLineHeight() * i,
+          "%s",
+          lines_[i].data());
+      rendered_lines_[i] = lines_[i];
+    }
   }
+  rendered_line_count_ = line_count_;
 }
 
 // Screen definitions
@@ -134,7 +192,7 @@ Screen::Screen()
     : name_button_(
           0,
           0,
-          420,
+          300,
           60,
           pros::Color::white,
           pros::Color::dark_red,
@@ -142,7 +200,21 @@ Screen::Screen()
           "",
           10,
           10,
-          pros::E_TEXT_LARGE),
+          pros::E_TEXT_LARGE,
+          [this]() { this->cycleAuto(); }),
+      driver_button_(
+          300,
+          0,
+          120,
+          60,
+          pros::Color::white,
+          pros::Color::dark_red,
+          2,
+          "",
+          10,
+          10,
+          pros::E_TEXT_MEDIUM,
+          [this]() { this->cycleDriver(); }),
       description_button_(
           0,
           60,
@@ -154,7 +226,8 @@ Screen::Screen()
           "",
           10,
           10,
-          pros::E_TEXT_MEDIUM),
+          pros::E_TEXT_MEDIUM,
+          [this]() { this->cycleAuto(); }),
       color_button_(
           420,
           0,
@@ -174,6 +247,16 @@ Screen::Screen()
 
 void Screen::initialize(size_t current_auto_index, bool is_red_team)
 {
+  if (!initialized_)
+  {
+    // Touches are handled on the screen task, which is woken as soon as one comes in
+    name_button_.attach(touch_dispatcher_);
+    driver_button_.attach(touch_dispatcher_);
+    description_button_.attach(touch_dispatcher_);
+    color_button_.attach(touch_dispatcher_);
+    touch_dispatcher_.start(&screen_task_);
+  }
+
   initialized_ = true;  // Initalized Called
   // Set Current Auto (Wrap to not use uninitialized memory)
   current_auto_index_ = autos_.empty() ? 0 : current_auto_index % autos_.size();
@@ -186,11 +269,9 @@ void Screen::addAutos(const std::vector<AutoInfo>& autos)
   autos_.insert(autos_.end(), autos.begin(), autos.end());
 }
 
-void Screen::addTelemetries(
-    const std::map<std::string, std::function<std::string()>>& telemetry_data)
+void Screen::addDrivers(const std::vector<std::string>& names)
 {
-  // Add telemetry data to the telemetry data list
-  telemetry_data_.insert(telemetry_data.begin(), telemetry_data.end());
+  drivers_.insert(drivers_.end(), names.begin(), names.end());
 }
 
 std::function<void(bool)> Screen::getCurrentAutoCallback() const
@@ -202,9 +283,24 @@ std::function<void(bool)> Screen::getCurrentAutoCallback() const
 const AutoInfo& Screen::getCurrentAuto() const { return autos_[current_auto_index_]; }
 void Screen::setRedTeam(bool isRedTeam) { is_red_team_ = isRedTeam; }
 bool Screen::getRedTeam() { return is_red_team_; }
+void Screen::setPaused(bool paused) { paused_.store(paused); }
+
+void Screen::cycleAuto()
+{
+  if (autos_.empty()) { return; }
+  current_auto_index_ = (current_auto_index_ + 1) % autos_.size();
+}
+
+void Screen::cycleDriver()
+{
+  if (drivers_.empty()) { return; }
+  current_driver_index_.store((current_driver_index_.load() + 1) % drivers_.size());
+}
 
 void Screen::run()
 {
+  bool was_paused = false;
+
   while (true)
   {
     // If not initalized
@@ -216,6 +312,47 @@ void Screen::run()
       continue;
     }
 
+    // Leave the display alone while another view is on it
+    if (paused_.load())
+    {
+      // Taps on the other view aren't for the selector
+      was_paused = true;
+      touch_dispatcher_.clear();
+      pros::delay(50);
+      continue;
+    }
+
+    if (was_paused)
+    {
+      // Give LVGL a refresh to clear its view, then draw everything again over it
+      was_paused = false;
+      pros::delay(100);
+      touch_dispatcher_.clear();
+      name_button_.invalidate();
+      driver_button_.invalidate();
+      description_button_.invalidate();
+      color_button_.invalidate();
+    }
+
+    // Presses change the auto or team before anything is drawn
+    touch_dispatcher_.dispatch();
+
+    // Color according to what color the team is
+    if (is_red_team_)
+    {
+      color_button_.setFillColor(pros::Color::red);
+      description_button_.setFillColor(pros::Color::dark_red);
+      name_button_.setFillColor(pros::Color::dark_red);
+      driver_button_.setFillColor(pros::Color::dark_red);
+    }
+    else
+    {
+      color_button_.setFillColor(pros::Color::blue);
+      description_button_.setFillColor(pros::Color::dark_blue);
+      name_button_.setFillColor(pros::Color::dark_blue);
+      driver_button_.setFillColor(pros::Color::dark_blue);
+    }
+
     // If Auto list empty
     if (autos_.empty())
     {
@@ -223,16 +360,7 @@ void Screen::run()
       name_button_.setText("No Autos Available");
 
       // Set the description
-      std::string description = "Please add autos to the list.\n";
-
-      // Add telemetry data to description
-      for (const auto& [key, value] : telemetry_data_)
-      {
-        description += key + ": " + value() + "\n";
-      }
-
-      // Update button name with new text
-      description_button_.setText(description);
+      description_button_.setText("Please add autos to the list.");
     }
     else
     {
@@ -240,50 +368,32 @@ void Screen::run()
       name_button_.setText(autos_[current_auto_index_].name);
 
       // Set the Description
-      std::string description = autos_[current_auto_index_].description + "\n";
+      description_button_.setText(autos_[current_auto_index_].description);
+    }
 
-      // Add the telemetry data to the description
-      for (const auto& [key, value] : telemetry_data_)
-      {
-        description += key + ": " + value() + "\n";
-      }
+    // Selected driver profile
+    if (!drivers_.empty()) { driver_button_.setText(drivers_[current_driver_index_.load()]); }
 
-      // Update the button name with new text
-      description_button_.setText(description);
+    // Format the telemetry data straight into the lines under the description
+    for (const ScreenTelemetry& telemetry : telemetry_data_)
+    {
+      char* line = description_button_.appendLine();
+      if (line == nullptr) { break; }
+
+      size_t size = RectButton::kLineLength - 1;
+      size_t length = std::min(
+          fmt::format_to_n(line, size, "{}: ", telemetry.label).size, size);
+      length += std::min(telemetry.write(line + length, size - length), size - length);
+      line[length] = '\0';
     }
 
     // Update all the buttons
     name_button_.update();
+    driver_button_.update();
     description_button_.update();
     color_button_.update();
 
-    // Check if the screen has been pressed (but isn't pressing)
-    if (screen_press_detector_.checkValue(
-            pros::screen::touch_status().touch_status == pros::last_touch_e_t::E_TOUCH_PRESSED) &&
-        screen_press_detector_.getValue())
-    {
-      // if color button not pressed, then cycle auto
-      if (!color_button_.getPressed())
-      {
-        current_auto_index_ = (current_auto_index_ + 1) % autos_.size();
-      }
-
-      // Color according to what color the team is
-      if (is_red_team_)
-      {
-        color_button_.setFillColor(pros::Color::red);
-        description_button_.setFillColor(pros::Color::dark_red);
-        name_button_.setFillColor(pros::Color::dark_red);
-      }
-      else
-      {
-        color_button_.setFillColor(pros::Color::blue);
-        description_button_.setFillColor(pros::Color::dark_blue);
-        name_button_.setFillColor(pros::Color::dark_blue);
-      }
-    }
-
-    // Don't hog the CPU
-    pros::delay(50);
+    // Sleep until the next frame, a touch wakes the task early so it is handled right away
+    pros::Task::notify_take(true, 50);
   }
 }
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "2131N/ui/touch_dispatcher.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "pros/screen.hpp"
+
+TouchDispatcher* TouchDispatcher::instance_ = nullptr;
+
+bool TouchDispatcher::addRegion(
+    int16_t x,
+    int16_t y,
+    int16_t width,
+    int16_t height,
+    Handler on_press,
+    Handler on_release)
+{
+  if (region_count_ == kMaxRegions) { return false; }
+
+  size_t index = region_count_++;
+  regions_[index] = {x, y, width, height, std::move(on_press), std::move(on_release)};
+
+  // Mark every cell the rectangle overlaps
+  auto cell = [](int16_t pixel, size_t cells) {
+    return std::clamp<int>(pixel / kCellSize, 0, static_cast<int>(cells) - 1);
+  };
+  for (int row = cell(y, kCellsY); row <= cell(y + height, kCellsY); row++)
+  {
+    for (int column = cell(x, kCellsX); column <= cell(x + width, kCellsX); column++)
+    {
+      cells_[row * kCellsX + column] |= static_cast<uint16_t>(1u << index);
+    }
+  }
+
+  return true;
+}
+
+void TouchDispatcher::start(pros::Task* notify_task)
+{
+  if (instance_ != nullptr) { return; }
+
+  notify_task_ = notify_task;
+  instance_ = this;
+  pros::screen::touch_callback(&TouchDispatcher::onPress, pros::E_TOUCH_PRESSED);
+  pros::screen::touch_callback(&TouchDispatcher::onRelease, pros::E_TOUCH_RELEASED);
+}
+
+int TouchDispatcher::hitTest(int16_t x, int16_t y) const
+{
+  if (x < 0 || y < 0) { return -1; }
+
+  size_t column = std::min<size_t>(x / kCellSize, kCellsX - 1);
+  size_t row = std::min<size_t>(y / kCellSize, kCellsY - 1);
+  uint16_t mask = cells_[row * kCellsX + column];
+
+  // Later regions are on top, so check from the highest bit down
+  for (int index = static_cast<int>(region_count_) - 1; index >= 0; index--)
+  {
+    if ((mask & (1u << index)) == 0) { continue; }
+
+    const Region& region = regions_[index];
+    if (x >= region.x && x <= region.x + region.width && y >= region.y &&
+        y <= region.y + region.height)
+    {
+      return index;
+    }
+  }
+
+  return -1;
+}
+
+size_t TouchDispatcher::dispatch()
+{
+  size_t handled = 0;
+  TouchEvent event;
+
+  while (events_.pop(event))
+  {
+    handled++;
+
+    if (event.type == TouchEventType::PRESS)
+    {
+      // A press is only reported once, however PROS repeats it
+      if (touching_) { continue; }
+      touching_ = true;
+
+      pressed_region_ = hitTest(event.x, event.y);
+      if (pressed_region_ >= 0) { regions_[pressed_region_].on_press(event); }
+    }
+    else
+    {
+      if (!touching_) { continue; }
+      touching_ = false;
+
+      // The release goes to whoever got the press, even if the finger slid off it
+      if (pressed_region_ >= 0) { regions_[pressed_region_].on_release(event); }
+      pressed_region_ = -1;
+    }
+  }
+
+  return handled;
+}
+
+void TouchDispatcher::clear()
+{
+  TouchEvent event;
+  while (events_.pop(event)) {}
+
+  // Let a held region know it is no longer pressed
+  if (touching_ && pressed_region_ >= 0)
+  {
+    regions_[pressed_region_].on_release({TouchEventType::RELEASE, -1, -1});
+  }
+
+  touching_ = false;
+  pressed_region_ = -1;
+}
+
+void TouchDispatcher::queue(TouchEventType type)
+{
+  // One device read per touch
+  pros::screen_touch_status_s_t touch = pros::screen::touch_status();
+  events_.push({type, touch.x, touch.y});
+
+  if (notify_task_ != nullptr) { notify_task_->notify(); }
+}
+
+void TouchDispatcher::onPress() { instance_->queue(TouchEventType::PRESS); }
+
+void TouchDispatcher::onRelease() { instance_->queue(TouchEventType::RELEASE); }
@@ -0,0 +1,83 @@
+#include "2131N/utils/command_cache.hpp"
+
+#include "pros/rtos.hpp"
+
+MotorCommand::MotorCommand(pros::AbstractMotor* motor, uint32_t keep_alive)
+    : motor_(motor), keep_alive_(keep_alive)
+{
+}
+
+bool MotorCommand::due(Mode mode, int32_t value)
+{
+  uint32_t now = pros::millis();
+  if (mode == mode_ && value == value_ && now - last_sent_ < keep_alive_)
+  {
+    skipped_++;
+    return false;
+  }
+
+  mode_ = mode;
+  value_ = value;
+  last_sent_ = now;
+  sent_++;
+  return true;
+}
+
+bool MotorCommand::moveVoltage(int32_t voltage)
+{
+  if (!this->due(Mode::VOLTAGE, voltage)) { return false; }
+
+  motor_->move_voltage(voltage);
+  return true;
+}
+
+bool MotorCommand::moveVelocity(int32_t velocity)
+{
+  if (!this->due(Mode::VELOCITY, velocity)) { return false; }
+
+  motor_->move_velocity(velocity);
+  return true;
+}
+
+bool MotorCommand::brake(pros::MotorBrake mode)
+{
+  // A new brake mode always goes out, even if the motor is already stopped
+  bool new_mode = mode != brake_mode_;
+  if (new_mode) { mode_ = Mode::NONE; }
+
+  if (!this->due(Mode::BRAKE, 0)) { return false; }
+
+  if (new_mode)
+  {
+    motor_->set_brake_mode_all(mode);
+    brake_mode_ = mode;
+  }
+  motor_->brake();
+  return true;
+}
+
+void MotorCommand::invalidate()
+{
+  mode_ = Mode::NONE;
+  brake_mode_ = pros::MotorBrake::invalid;
+}
+
+PneumaticCommand::PneumaticCommand(pros::adi::Pneumatics* pneumatic, uint32_t keep_alive)
+    : pneumatic_(pneumatic), keep_alive_(keep_alive)
+{
+}
+
+bool PneumaticCommand::set(bool extended)
+{
+  uint32_t now = pros::millis();
+  if (known_ && extended == pneumatic_->is_extended() && now - last_sent_ < keep_alive_)
+  {
+    return false;
+  }
+
+  if (extended) { pneumatic_->extend(); }
+  else { pneumatic_->retract(); }
+  known_ = true;
+  last_sent_ = now;
+  return true;
+}
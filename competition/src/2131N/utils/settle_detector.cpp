@@ -0,0 +1,62 @@
+#include "2131N/utils/settle_detector.hpp"
+
+#include <cmath>
+
+SettleDetector::SettleDetector(SettleSettings settings) : settings_(settings) {}
+
+bool SettleDetector::update(float error, float velocity, float dT)
+{
+  if (dT <= 0.0f) { return settled_; }
+
+  // Change in error per second, lightly smoothed to keep odometry noise out of it
+  float raw_rate = first_update_ ? 0.0f : (error - previous_error_) / (dT / 1000.0f);
+  error_rate_ = first_update_ ? raw_rate : 0.5f * raw_rate + 0.5f * error_rate_;
+  previous_error_ = error;
+  first_update_ = false;
+
+  // If the error is shrinking, the robot keeps travelling v^2 / 2a before it stops
+  float closing_speed = -error_rate_ * (error >= 0.0f ? 1.0f : -1.0f);
+  float stopping_distance = 0.0f;
+  if (closing_speed > 0.0f && settings_.deceleration > 0.0f)
+  {
+    stopping_distance = closing_speed * closing_speed / (2.0f * settings_.deceleration);
+  }
+  projected_error_ = std::fabs(std::fabs(error) - stopping_distance);
+
+  // Exit once the robot is stopped on target, or while closing once braking now would stop it
+  // within tolerance (then the chassis ends the motion early and brakes the rest of the way)
+  bool slow = std::fabs(velocity) <= settings_.max_velocity;
+  bool steady = std::fabs(error_rate_) <= settings_.max_error_rate;
+  bool stopped_on_target = slow && steady && std::fabs(error) <= settings_.tolerance;
+  bool braking_on_target =
+      project_ && closing_speed > 0.0f && projected_error_ <= settings_.tolerance;
+
+  if (stopped_on_target || braking_on_target)
+  {
+    settled_time_ += dT;
+    settled_ = settled_time_ >= settings_.settle_time;
+  }
+  else
+  {
+    settled_ = false;
+    settled_time_ = 0.0f;
+  }
+
+  return settled_;
+}
+
+void SettleDetector::setProjection(bool enabled) { project_ = enabled; }
+
+float SettleDetector::getProjectedError() const { return projected_error_; }
+float SettleDetector::getErrorRate() const { return error_rate_; }
+bool SettleDetector::getSettled() const { return settled_; }
+
+void SettleDetector::reset()
+{
+  previous_error_ = 0.0f;
+  error_rate_ = 0.0f;
+  projected_error_ = 0.0f;
+  settled_time_ = 0.0f;
+  first_update_ = true;
+  settled_ = false;
+}
@@ -42,6 +42,7 @@ float VelocityController::calculate(float current_velocity, float target_velocit
     // If the error is within the deadband, return 0 to avoid unnecessary movement
     previous_error = error;  // Update previous error to maintain integral and derivative terms
     integral = 0.0f;         // Reset integral to avoid windup
+    previous_output = 0.0f;  // Slew up from rest when the target comes back
     return 0.0f;
   }
 
@@ -66,10 +67,11 @@ float VelocityController::calculate(float current_velocity, float target_velocit
 
   float voltage_derivative = (output - previous_output);
 
-  // Apply a slew rate limit to the output
-  if (std::fabs(voltage_derivative) > kSlew)
+  // Apply a slew rate limit to the output (kSlew is per second, dT is in milliseconds)
+  float max_step = kSlew * dT / 1000.0f;
+  if (kSlew > 0.0f && std::fabs(voltage_derivative) > max_step)
   {
-    output = previous_output + std::copysign(kSlew, voltage_derivative) * dT;
+    output = previous_output + std::copysign(max_step, voltage_derivative);
   }
 
   previous_output = output;  // Store the output for future use
@@ -79,6 +81,7 @@ float VelocityController::calculate(float current_velocity, float target_velocit
 
 void VelocityController::reset()
 {
-  previous_error = 0.0f;  // Update previous error to maintain integral and derivative terms
-  integral = 0.0f;        // Reset integral to avoid windup
+  previous_error = 0.0f;   // Update previous error to maintain integral and derivative terms
+  previous_output = 0.0f;  // Slew from rest
+  integral = 0.0f;         // Reset integral to avoid windup
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "autonomous.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 #include "2131N/robot-config.hpp"
@@ -15,6 +16,7 @@ void leftSideAwp(bool is_red_team)
 {
 middle_lift.extend();
   intake.setState(Intake::states::STORING);
+  intake.addStored(1);  // Preload
 
   chassis.setPose({87.75, 24, 90}, false);
   
@@ -54,9 +56,13 @@ middle_lift.extend();
    //! Grab Middle
    chassis.turnToPoint(98, 47.25, 400, {.minSpeed = 45});
    chassis.moveToPoint(98, 47.25, 1000, {.maxSpeed = 125, .minSpeed = 55}, true);
-   pros::delay(200);
-   matchload_unloader.extend();
-   pros::delay(450);
+   // Drop the unloader partway to the blocks (or on them if the motion ends short), then sit on
+   // them for a moment like the old fixed timing did
+   triggers.schedule(
+       TriggerCondition::traveled(4.0), []() { matchload_unloader.extend(); }, 1000, true);
+   triggers.waitFor(TriggerCondition::near(98, 47.25, 3.0, 50), 1000);
+   triggers.expire();
+   pros::delay(250);
    matchload_unloader.retract();
 
    chassis.turnToPoint(46, 6.5, 500, {.minSpeed = 52});
@@ -118,7 +124,8 @@ middle_lift.extend();
 //  //intake.setState(Intake::states::OUTTAKE);
    pros::delay(100);
   intake.setState(Intake::states::SCORING);
-   pros::delay(1600);
+   // Leave once everything held is scored, never later than the old fixed 1600 ms
+   intake.waitUntilScored(std::max<size_t>(intake.getHeld(), 1), 1600);
 
 
 
@@ -128,6 +135,7 @@ void leftSide(bool is_red_team)
 {
   middle_lift.extend();
   intake.setState(Intake::states::STORING);
+  intake.addStored(1);  // Preload
 
   chassis.setPose({48 + 7.25 + 1., 24, -90}, false);
   
@@ -148,7 +156,7 @@ void leftSide(bool is_red_team)
  intake.setState(Intake::states::OUTTAKE);
   pros::delay(100);
  intake.setState(Intake::states::SCORING);
-  pros::delay(1200);
+  intake.waitUntilScored(std::max<size_t>(intake.getHeld(), 1), 1200);
  
   matchload_unloader.retract();
   chassis.cancelMotion();
@@ -209,6 +217,7 @@ void rightSide(bool is_red_team)
 {
   middle_lift.extend();
   intake.setState(Intake::states::STORING);
+  intake.addStored(1);  // Preload
 
   chassis.setPose({87.75, 24, 90}, false);
   
@@ -230,7 +239,7 @@ void rightSide(bool is_red_team)
   chassis.moveToRelativePoint(Chassis::fromPolar(0, -0.5), 200, {.forwards = false, .minSpeed = 100}, true);
    pros::delay(100);
   intake.setState(Intake::states::SCORING);
-   pros::delay(1300);
+   intake.waitUntilScored(std::max<size_t>(intake.getHeld(), 1), 1300);
  
    matchload_unloader.retract();
    chassis.cancelMotion();
@@ -245,11 +254,13 @@ void rightSide(bool is_red_team)
    //intake.setState(Intake::states::STORING);
    chassis.turnToPoint(98, 47.25, 400, {.minSpeed = 45});
    chassis.moveToPoint(96.25, 47.25, 1000, {.maxSpeed = 125, .minSpeed = 55}, true);
-   pros::delay(200);
 
    //! grabbing blocks
-   matchload_unloader.extend();
-   pros::delay(390);
+   triggers.schedule(
+       TriggerCondition::traveled(4.0), []() { matchload_unloader.extend(); }, 1000, true);
+   triggers.waitFor(TriggerCondition::near(96.25, 47.25, 3.0, 50), 1000);
+   triggers.expire();
+   pros::delay(190);
    matchload_unloader.retract();
    
    chassis.turnToHeading(-50, 640, {.maxSpeed = 60, .minSpeed = 47}, false);
@@ -333,8 +344,14 @@ chassis.turnToHeading(-7, 600, {}, false);
   middle_lift.extend();
 
   chassis.moveToPoint(19.5, 88, 1000, {.forwards = false, .maxSpeed = 61.5, .minSpeed = 22}, true);
-  pros::delay(450);
-  intake.setState(Intake::states::SCORING);
+  // Start scoring as the robot reaches the goal instead of after a padded delay
+  // Scores at the timeout even if the goal is never reached
+  triggers.schedule(
+      TriggerCondition::near(19.5, 88, 6.0, 100),
+      []() { intake.setState(Intake::states::SCORING); },
+      1000,
+      true);
+  if (!triggers.waitUntilIdle(1000)) { triggers.expire(); }
   pros::delay(600);
   intake.setState(Intake::states::OUTTAKE);
   pros::delay(100);
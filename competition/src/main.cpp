@@ -19,6 +19,18 @@ void initialize()
   chassis.calibrate(true);
   mcl_localization.set_enabled(false);
 
+  // Periodic subsystems, faster jobs get higher priorities
+  scheduler.addJob("Intake Update", 10, 10, []() { intake.update(); });
+  scheduler.addJob("MCL Update", 20, 20, []() { mcl_localization.update(); });
+  scheduler.start();
+
+  // Record odometry, MCL and intake telemetry when there's a card in the brain
+  if (pros::usd::is_installed()) { telemetry.open(TelemetrySink::SD); }
+
+  // Live dashboard (tools/serial_receive.cpp), takes stdout away from `pros terminal`
+  constexpr bool kSerialDashboard = false;
+  if (kSerialDashboard) { serial_telemetry.start(); }
+
   screen.addAutos({
       {"Debug", "Debug Auto, DO NOT RUN AT COMP", debug},     //this one counts as 0, so left side is 1
       {"Left Side", "Left Side Half Autonomous Win Point danielle's slay queen", leftSide},  //1
@@ -34,27 +46,42 @@ void initialize()
       {"Right Side 9 Block", " Right Side 9 Block ", RightSide9Block}, //11
   }); 
 
+  screen.addTelemetry<"{:.0f}%">("Battery", []() { return pros::battery::get_capacity(); });
+  screen.addTelemetry<"({:.2f}, {:.2f}, {:.2f})">("Position", []() {
+    auto position = chassis.getPose();
+    return std::tuple(position.x, position.y, position.theta);
+  });
+  screen.addTelemetry<"X: {:.2f}  Y: {:.2f}">("Position (MCL)", []() {
+    auto position = mcl_localization.get_point_estimate();
+    return std::tuple(position.x, position.y);
+  });
+  screen.addTelemetry<"{:.0f}%  Overruns: {}">("Jobs", []() {
+    return std::tuple(scheduler.getUtilization() * 100.0f, scheduler.getOverruns());
+  });
+  screen.addTelemetry<"{} held  {:.1f}/s">("Balls", []() {
+    return std::tuple(intake.getHeld(), intake.getScoreRate());
+  });
+
+  std::vector<std::string> drivers;
+  for (const DriverProfile& profile : driver_profiles) { drivers.push_back(profile.name); }
+  screen.addDrivers(drivers);
+
   screen.initialize(1, true);
 
-  screen.addTelemetries(
-      {{"Battery", []() { return std::to_string(pros::battery::get_capacity()); }},
-       {"Position",
-        []() -> std::string {
-          auto position = chassis.getPose();
-          return "  (" + std::to_string(position.x) + ", " + std::to_string(position.y) + ", " +
-                 std::to_string(position.theta) + ")";
-        }},
-       {"Position (MCL)", []() -> std::string {
-          auto position = mcl_localization.get_point_estimate();
-          return "  X: " + std::to_string(position.x) + "  Y: " + std::to_string(position.y);
-        }}});
+  // Field view with the MCL particles for tuning, tap it to get back to the auto selector
+  constexpr bool kFieldView = false;
+  if (kFieldView) { field_view.show(); }
 }
 
 /**
  * @brief Runs when the robot is disabled.
  *
  */
-void disabled() {}
+void disabled()
+{
+  // Close the recording so it's safe on the card when the field turns the robot off
+  match_recorder.stop();
+}
 
 /**
  * @brief Runs when field control is plugged in.
@@ -68,6 +95,8 @@ void competition_initialize() {}
  */
 void autonomous()
 {
+  match_recorder.start();
+
   //middle_lift.extend();
   goal_descore_right.extend();
   //middleGoalFlap.extend();
@@ -81,6 +110,8 @@ void autonomous()
  */
 void opcontrol()
 {
+  match_recorder.start();
+
   intake.setIntakeMultiplier(1.0, 1.0, 1.0);
   intake.setMiddle(false);
 
@@ -88,39 +119,47 @@ void opcontrol()
   intake.setState(Intake::states::STOPPED);
 
   chassis.setBrakeMode(pros::E_MOTOR_BRAKE_COAST);
+  chassis.setTractionControl(true);
+
+  // Stick curves and slew for the driver picked on the screen
+  DriveShaper drive_shaper(&driver_profiles[0]);
 
+  // One controller read per tick, at the rate the controller sends new data
+  uint32_t now = pros::millis();
   while (true)
   {
-    intake.teleOp();
+    const ControllerSnapshot& input = controller_input.update();
+    drive_shaper.setProfile(&driver_profiles[screen.getDriver() % driver_profiles.size()]);
+    intake.teleOp(input);
 
-    if (primary.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_RIGHT))
+    if (input.isPressed(pros::E_CONTROLLER_DIGITAL_RIGHT))
     {
       matchload_unloader.toggle();
     }
 
-    if (primary.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_R2))
+    if (input.isPressed(pros::E_CONTROLLER_DIGITAL_R2))
     {
       middle_lift.toggle();
       // goal_descore_right.extend();
     }
-    else if (primary.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_DOWN))
+    else if (input.isPressed(pros::E_CONTROLLER_DIGITAL_DOWN))
     {
       goal_descore_right.toggle();
     }
-    // else if (primary.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_R1))
+    // else if (input.isPressed(pros::E_CONTROLLER_DIGITAL_R1))
     // {
     // storage_block.toggle();
     // }
 
-    // if (primary.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_UP))
+    // if (input.isPressed(pros::E_CONTROLLER_DIGITAL_UP))
     // { 
     //   //first_stage_lift.extend();
     // }
-    // else if (primary.get_digital_new_release(pros::E_CONTROLLER_DIGITAL_UP))
+    // else if (input.isReleased(pros::E_CONTROLLER_DIGITAL_UP))
     // {
     //   //first_stage_lift.retract();
     // }
-    if (primary.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_B))
+    if (input.isPressed(pros::E_CONTROLLER_DIGITAL_B))
     {
 
       matchload_unloader.retract();
@@ -128,32 +167,23 @@ void opcontrol()
       middle_descore.extend();
 
     }
-    else if(primary.get_digital_new_release(pros::E_CONTROLLER_DIGITAL_B))
+    else if(input.isReleased(pros::E_CONTROLLER_DIGITAL_B))
     {
       middle_descore.retract();
     }
 
-    if (primary.get_digital(pros::E_CONTROLLER_DIGITAL_Y))
-    {
-      chassis.tank_with_dead_zone(
-          primary.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y) * 0.5,
-          primary.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y) * 0.5,
-          17,
-          false);
-          
-          intake.setIntakeMultiplier(1.0, 1.0, 0.29);
-      
-    } 
-    
-    else
-    {
-      chassis.tank_with_dead_zone(
-          primary.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y),
-          primary.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y),
-          17,
-          false);
-      
-          intake.setIntakeMultiplier(1.0, 1.0, 1.0);
-    }
+    // Y is precision, the drive uses the driver's slow curve and the top stage slows down
+    bool precision = input.isHeld(pros::E_CONTROLLER_DIGITAL_Y);
+    auto [left, right] = drive_shaper.shape(
+        input.getAnalog(pros::E_CONTROLLER_ANALOG_LEFT_Y),
+        input.getAnalog(pros::E_CONTROLLER_ANALOG_RIGHT_Y),
+        precision,
+        ControllerInput::kPeriod);
+    chassis.tank(left, right);
+
+    if (precision) { intake.setIntakeMultiplier(1.0, 1.0, 0.29); }
+    else { intake.setIntakeMultiplier(1.0, 1.0, 1.0); }
+
+    pros::Task::delay_until(&now, ControllerInput::kPeriod);
   }
 }
\ No newline at end of file
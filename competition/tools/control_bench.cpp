@@ -0,0 +1,208 @@
+/**
+ * @file control_bench.cpp
+ * @author Andrew Hilton (2131N)
+ * @brief Host microbenchmark of the control templates against the PID, VelocityController and
+ * ThreeTapSMA classes they can replace
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Build (from competition/):  g++ -std=c++20 -O2 -Iinclude tools/control_bench.cpp \
+ *                                 src/2131N/utils/pid.cpp src/2131N/utils/filters.cpp \
+ *                                 src/2131N/utils/velocity_controller.cpp -o control_bench
+ * Usage:                      ./control_bench [updates]
+ *
+ * Times are per channel update. The host is much faster than the brain's Cortex-A9, so only
+ * the ratios carry over. "max diff" is the largest output difference from the existing class
+ * over the run, as a check that the template does the same thing.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+
+#include "2131N/utils/control.hpp"
+#include "2131N/utils/filters.hpp"
+#include "2131N/utils/pid.hpp"
+#include "2131N/utils/velocity_controller.hpp"
+
+namespace
+{
+constexpr size_t kChannels = 8;  // Channels in the batched runs
+
+constexpr PidGains kPid{.kP = 2.0f, .kI = 0.001f, .kD = 5.0f, .integral_windup = 50.0f};
+constexpr FeedforwardGains kFeedforward{.kS = 500.0f, .kV = 60.0f, .kA = 0.0f};
+constexpr PidGains kVelocityPid{.kP = 30.0f};
+constexpr SlewGains kSlew{.rate = 120000.0f};
+constexpr float kDeadBand = 5.0f;
+
+static_assert(std::is_copy_assignable_v<StaticPid<float, kPid>>);
+static_assert(std::is_copy_assignable_v<StaticPid<Fixed, kPid, kChannels>>);
+static_assert(!std::is_copy_assignable_v<PID>);
+
+volatile float sink;  // Keeps the optimiser from dropping the work
+
+/**
+ * @brief Time a run of updates
+ *
+ * @param name Row label
+ * @param updates Channel updates in the run
+ * @param run Does the run, returns the largest difference from the reference
+ */
+template <typename Run>
+void bench(const char* name, size_t updates, Run run)
+{
+  auto start = std::chrono::steady_clock::now();
+  float diff = run();
+  auto end = std::chrono::steady_clock::now();
+
+  double ns = std::chrono::duration<double, std::nano>(end - start).count() / updates;
+  std::printf("%-36s %8.2f ns   max diff %g\n", name, ns, diff);
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  size_t steps = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+  // Errors and targets that look like a loop settling, different for every channel
+  std::vector<float> signal(steps * kChannels);
+  for (size_t i = 0; i < signal.size(); i++)
+  {
+    size_t channel = i % kChannels;
+    signal[i] = 150.0f * std::sin(i / kChannels * 0.01f + channel) + 20.0f * std::sin(i * 0.37f);
+  }
+
+  // Reference outputs from the existing classes
+  std::vector<float> pid_reference(steps);
+  std::vector<float> velocity_reference(steps);
+  std::vector<float> sma_reference(steps);
+
+  std::printf("%zu updates, %zu channels batched\n\n", steps, kChannels);
+
+  bench("PID", steps, [&]() {
+    PID pid(kPid.kP, kPid.kI, kPid.kD, kPid.integral_windup);
+    for (size_t i = 0; i < steps; i++) { pid_reference[i] = pid.calculate(signal[i * kChannels]); }
+    sink = pid_reference[steps - 1];
+    return 0.0f;
+  });
+
+  auto pid_single = [&]<typename T>(const char* name) {
+    bench(name, steps, [&]() {
+      StaticPid<T, kPid> pid;
+      float diff = 0.0f;
+      for (size_t i = 0; i < steps; i++)
+      {
+        float output = static_cast<float>(pid.update(T(signal[i * kChannels])));
+        diff = std::max(diff, std::abs(output - pid_reference[i]));
+      }
+      sink = diff;
+      return diff;
+    });
+  };
+  pid_single.operator()<float>("StaticPid<float>");
+  pid_single.operator()<double>("StaticPid<double>");
+  pid_single.operator()<Fixed>("StaticPid<Fixed>");
+
+  bench("PID x8", steps * kChannels, [&]() {
+    std::vector<PID> pids(kChannels, PID(kPid.kP, kPid.kI, kPid.kD, kPid.integral_windup));
+    float total = 0.0f;
+    for (size_t i = 0; i < steps; i++)
+    {
+      for (size_t c = 0; c < kChannels; c++)
+      {
+        total += pids[c].calculate(signal[i * kChannels + c]);
+      }
+    }
+    sink = total;
+    return 0.0f;
+  });
+
+  auto pid_batched = [&]<typename T>(const char* name) {
+    bench(name, steps * kChannels, [&]() {
+      StaticPid<T, kPid, kChannels> pid;
+      typename StaticPid<T, kPid, kChannels>::Values error;
+      float total = 0.0f;
+      for (size_t i = 0; i < steps; i++)
+      {
+        for (size_t c = 0; c < kChannels; c++) { error[c] = T(signal[i * kChannels + c]); }
+        for (T output : pid.update(error)) { total += static_cast<float>(output); }
+      }
+      sink = total;
+      return 0.0f;
+    });
+  };
+  pid_batched.operator()<float>("StaticPid<float, 8>");
+  pid_batched.operator()<Fixed>("StaticPid<Fixed, 8>");
+
+  std::printf("\n");
+
+  // Velocity loops run on a moving target with the measured value lagging behind it
+  bench("VelocityController", steps, [&]() {
+    VelocityController controller(
+        kFeedforward.kS,
+        kFeedforward.kV,
+        kFeedforward.kA,
+        kVelocityPid.kP,
+        0.0f,
+        0.0f,
+        kSlew.rate,
+        0.0f,
+        kDeadBand);
+    for (size_t i = 0; i < steps; i++)
+    {
+      float target = signal[i * kChannels];
+      velocity_reference[i] = controller.calculate(target * 0.9f, target);
+    }
+    sink = velocity_reference[steps - 1];
+    return 0.0f;
+  });
+
+  auto velocity_single = [&]<typename T>(const char* name) {
+    bench(name, steps, [&]() {
+      StaticVelocityController<T, kFeedforward, kVelocityPid, kSlew, kDeadBand> controller;
+      float diff = 0.0f;
+      for (size_t i = 0; i < steps; i++)
+      {
+        float target = signal[i * kChannels];
+        float output = static_cast<float>(controller.update(T(target * 0.9f), T(target)));
+        diff = std::max(diff, std::abs(output - velocity_reference[i]));
+      }
+      sink = diff;
+      return diff;
+    });
+  };
+  velocity_single.operator()<float>("StaticVelocityController<float>");
+  velocity_single.operator()<Fixed>("StaticVelocityController<Fixed>");
+
+  std::printf("\n");
+
+  bench("ThreeTapSMA", steps, [&]() {
+    ThreeTapSMA sma;
+    for (size_t i = 0; i < steps; i++) { sma_reference[i] = sma.filter(signal[i * kChannels]); }
+    sink = sma_reference[steps - 1];
+    return 0.0f;
+  });
+
+  auto sma_single = [&]<typename T>(const char* name) {
+    bench(name, steps, [&]() {
+      StaticMovingAverage<T, 3> sma;
+      float diff = 0.0f;
+      for (size_t i = 0; i < steps; i++)
+      {
+        float output = static_cast<float>(sma.update(T(signal[i * kChannels])));
+        diff = std::max(diff, std::abs(output - sma_reference[i]));
+      }
+      sink = diff;
+      return diff;
+    });
+  };
+  sma_single.operator()<float>("StaticMovingAverage<float, 3>");
+  sma_single.operator()<Fixed>("StaticMovingAverage<Fixed, 3>");
+
+  return 0;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file intake_machine_check.cpp
+ * @author Andrew Hilton (2131N)
+ * @brief Host check of the intake state machine's transition table
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Build (from competition/):  g++ -std=c++20 -O2 -Iinclude tools/intake_machine_check.cpp \
+ *                                 -o intake_machine_check
+ * Usage:                      ./intake_machine_check
+ *
+ * Plays button, jam and timeout sequences through IntakeMachine and checks where each ends up,
+ * then checks which stages the jam detector watches while storing and how the ball tracker
+ * counts storage and ejects. Prints one line per case and exits non zero if any fail.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+
+#include "2131N/systems/ball_tracker.hpp"
+#include "2131N/systems/intake_machine.hpp"
+
+namespace
+{
+constexpr const char* kStateNames[] = {
+    "STOPPED",
+    "OUTTAKE",
+    "OUTTAKEMIDDLE",
+    "STORING",
+    "SCORING",
+    "SCORE_MIDDLE",
+    "STORE_TOP",
+    "ANTI_JAM",
+    "RUNNING",
+    "REVERSING",
+    "ROOT",
+    "HISTORY",
+    "INTERNAL"};
+
+int failures = 0;
+
+/**
+ * @brief Print a case and count it if it failed
+ *
+ * @param name Case name
+ * @param result What came out
+ * @param passed Did it come out right
+ */
+void check(const char* name, const std::string& result, bool passed)
+{
+  if (!passed) { failures++; }
+  std::printf("%-48s %-14s %s\n", name, result.c_str(), passed ? "ok" : "FAILED");
+}
+
+/**
+ * @brief Check the machine is in a state
+ *
+ * @param name Case name
+ * @param machine Machine
+ * @param expected State it should be in
+ */
+void expect(const char* name, const IntakeMachine& machine, IntakeState expected)
+{
+  check(
+      name,
+      kStateNames[static_cast<size_t>(machine.getState())],
+      machine.getState() == expected);
+}
+
+/**
+ * @brief Check which stages the jam detector watches
+ *
+ * @param name Case name
+ * @param machine Machine
+ * @param bottom Bottom stage should be watched
+ * @param middle Middle stage should be watched
+ * @param top Top stage should be watched
+ */
+void expectWatched(
+    const char* name,
+    const IntakeMachine& machine,
+    bool bottom,
+    bool middle,
+    bool top)
+{
+  bool watched[] = {machine.checksJams(0), machine.checksJams(1), machine.checksJams(2)};
+  std::string result;
+  for (bool stage : watched) { result += stage ? '1' : '0'; }
+  check(name, result, watched[0] == bottom && watched[1] == middle && watched[2] == top);
+}
+
+/**
+ * @brief Send events the way Intake does, keeping intake_held in step with the buttons
+ *
+ * @param machine Machine
+ * @param events Events in order
+ * @param now Time of the events (ms)
+ */
+void send(IntakeMachine& machine, std::initializer_list<IntakeEvent> events, uint32_t now = 0)
+{
+  for (IntakeEvent event : events)
+  {
+    if (event == IntakeEvent::INTAKE_PRESSED) { machine.getContext().intake_held = true; }
+    if (event == IntakeEvent::RELEASED || event == IntakeEvent::OUTTAKE_PRESSED)
+    {
+      machine.getContext().intake_held = false;
+    }
+    machine.dispatch(event, now);
+  }
+}
+}  // namespace
+
+int main()
+{
+  using enum IntakeEvent;
+  using enum IntakeState;
+
+  {
+    IntakeMachine machine;
+    send(machine, {INTAKE_PRESSED});
+    expect("intake stores", machine, STORING);
+    machine.getContext().score_mode = true;
+    send(machine, {SCORE_MODE_CHANGED});
+    expect("score mode while held scores", machine, SCORING);
+    send(machine, {RELEASED});
+    expect("release stops", machine, STOPPED);
+    send(machine, {OUTTAKE_PRESSED});
+    expect("outtake", machine, OUTTAKE);
+  }
+
+  {
+    IntakeMachine machine;
+    send(machine, {INTAKE_PRESSED, JAM}, 100);
+    expect("jam reverses", machine, ANTI_JAM);
+    send(machine, {RELEASED, INTAKE_PRESSED}, 150);
+    expect("buttons don't cancel the unjam", machine, ANTI_JAM);
+    uint32_t elapsed = machine.getTimeInState(150);
+    check("  ...or restart its timer", std::to_string(elapsed) + " ms", elapsed == 50);
+    send(machine, {TIMEOUT}, 400);
+    expect("unjam resumes storing", machine, STORING);
+  }
+
+  {
+    IntakeMachine machine;
+    send(machine, {INTAKE_PRESSED, JAM, RELEASED, TIMEOUT});
+    expect("released during the unjam stops after", machine, STOPPED);
+  }
+
+  {
+    IntakeMachine machine;
+    send(machine, {INTAKE_PRESSED, JAM, OUTTAKE_PRESSED, TIMEOUT});
+    expect("outtake during the unjam outtakes after", machine, OUTTAKE);
+  }
+
+  {
+    IntakeMachine machine;
+    send(machine, {INTAKE_PRESSED, JAM});
+    machine.getContext().score_mode = true;
+    send(machine, {SCORE_MODE_CHANGED, TIMEOUT});
+    expect("score mode during the unjam scores after", machine, SCORING);
+  }
+
+  {
+    IntakeMachine machine;
+    send(machine, {INTAKE_PRESSED, JAM, JAM, TIMEOUT});
+    expect("jam again keeps the state to go back to", machine, STORING);
+    uint32_t jams = machine.getContext().jams;
+    check("  ...and counts both jams", std::to_string(jams) + " jams", jams == 2);
+  }
+
+  {
+    IntakeMachine machine;
+    send(machine, {INTAKE_PRESSED, JAM});
+    machine.force(OUTTAKEMIDDLE, 0);
+    expect("force leaves the unjam (autonomous)", machine, OUTTAKEMIDDLE);
+  }
+
+  {
+    IntakeMachine machine;
+    send(machine, {INTAKE_PRESSED});
+    expectWatched("storing leaves the held top stage alone", machine, true, true, false);
+
+    // Intake sets storage_full from the tracker every update
+    BallTracker tracker;
+    tracker.addStored(1);
+    machine.getContext().storage_full = tracker.isHeldBack(1);
+    expectWatched("  ...and the middle once storage is full", machine, true, false, false);
+
+    machine.getContext().score_mode = true;
+    send(machine, {SCORE_MODE_CHANGED});
+    expectWatched("scoring watches every stage", machine, true, true, true);
+    send(machine, {RELEASED});
+    expectWatched("stopped watches none", machine, false, false, false);
+  }
+
+  {
+    BallTracker tracker;
+    tracker.ballEntered();
+    bool held = tracker.isHeldBack(1);
+    tracker.update({350.0f, 0.0f, -100.0f}, 0);
+    tracker.update({0.0f, 700.0f, -100.0f}, 0);
+    bool full = tracker.isHeldBack(1);
+    check("a ball stopped by the top fills storage", full ? "full" : "not full", !held && full);
+  }
+
+  {
+    // The 100 ms outtake pulse before scoring, then a real outtake
+    BallTracker tracker;
+    tracker.ballEntered();
+    for (uint32_t now = 10; now <= 100; now += 10) { tracker.update({-60.0f, 0.0f, 0.0f}, now); }
+    uint32_t pulse = tracker.getEjected();
+    tracker.update({60.0f, 0.0f, 0.0f}, 110);
+    for (uint32_t now = 120; now <= 400; now += 10) { tracker.update({-60.0f, 0.0f, 0.0f}, now); }
+    uint32_t outtake = tracker.getEjected();
+    check(
+        "an outtake pulse ejects nothing, an outtake does",
+        std::to_string(pulse) + ", " + std::to_string(outtake),
+        pulse == 0 && outtake == 1);
+  }
+
+  std::printf("\n%d failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
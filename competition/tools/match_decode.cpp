@@ -0,0 +1,216 @@
+/**
+ * @file match_decode.cpp
+ * @author Andrew Hilton (2131N)
+ * @brief Host tool that converts match recordings to CSV and columnar files
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Build (from competition/):  g++ -std=c++20 -O2 -Iinclude tools/match_decode.cpp -o match_decode
+ * Usage:                      ./match_decode match_000.bin match_000
+ *
+ * Writes <prefix>.csv (one row per frame) and <prefix>.col, a columnar file laid out as
+ *   "MCOL", uint32 column count, uint32 row count,
+ *   per column: uint8 name length, name,
+ *   then every column as row count little-endian float64 values, one column after another.
+ * In numpy: skip the header, then np.fromfile(..., dtype="<f8").reshape(columns, rows).
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "2131N/systems/match_format.hpp"
+
+struct Column
+{
+  std::string name;
+  std::vector<double> values;
+};
+
+int main(int argc, char** argv)
+{
+  if (argc != 3)
+  {
+    std::fprintf(stderr, "usage: %s <recording.bin> <output prefix>\n", argv[0]);
+    return 1;
+  }
+
+  FILE* input = std::fopen(argv[1], "rb");
+  if (input == nullptr)
+  {
+    std::fprintf(stderr, "can't open %s\n", argv[1]);
+    return 1;
+  }
+
+  MatchFileInfo info{};
+  bool have_info = false;
+  std::vector<Column> columns;
+  size_t rows = 0;
+  size_t index_blocks = 0;
+  uint32_t expected_sequence = 0;
+
+  uint8_t block[kMatchBlockSize];
+  while (std::fread(block, kMatchBlockSize, 1, input) == 1)
+  {
+    MatchBlockHeader header;
+    std::memcpy(&header, block, sizeof(header));
+
+    if (header.magic != kMatchMagic || header.version != kMatchVersion)
+    {
+      std::fprintf(stderr, "bad block after sequence %u, stopping\n", expected_sequence);
+      break;
+    }
+    if (header.sequence != expected_sequence)
+    {
+      std::fprintf(stderr, "blocks %u-%u missing\n", expected_sequence, header.sequence - 1);
+    }
+    expected_sequence = header.sequence + 1;
+
+    switch (static_cast<MatchBlockType>(header.type))
+    {
+      case MatchBlockType::HEADER:
+      {
+        std::memcpy(&info, block + sizeof(header), sizeof(info));
+        if (info.frame_size != sizeof(MatchFrame))
+        {
+          std::fprintf(stderr, "frame size %u doesn't match this decoder\n", info.frame_size);
+          return 1;
+        }
+        have_info = true;
+
+        for (const char* name :
+             {"timestamp", "x", "y", "theta", "velocity", "angular_velocity", "mcl_x", "mcl_y",
+              "mcl_variance"})
+        {
+          columns.push_back({name, {}});
+        }
+        for (int i = 0; i < info.distance_count; i++)
+        {
+          columns.push_back({"distance_" + std::to_string(i), {}});
+        }
+        for (int i = 0; i < info.motor_count; i++)
+        {
+          columns.push_back({"voltage_" + std::to_string(i), {}});
+          columns.push_back({"current_" + std::to_string(i), {}});
+          columns.push_back({"temperature_" + std::to_string(i), {}});
+        }
+        for (const char* name : {"battery_voltage", "intake_state", "ball_detected"})
+        {
+          columns.push_back({name, {}});
+        }
+        break;
+      }
+
+      case MatchBlockType::DATA:
+      {
+        if (!have_info)
+        {
+          std::fprintf(stderr, "data before the header block\n");
+          return 1;
+        }
+
+        for (size_t f = 0; f < header.count && f < kMatchFramesPerBlock; f++)
+        {
+          MatchFrame frame;
+          std::memcpy(&frame, block + sizeof(header) + f * sizeof(MatchFrame), sizeof(frame));
+
+          size_t c = 0;
+          for (double value :
+               {double(frame.timestamp), double(frame.x), double(frame.y), double(frame.theta),
+                double(frame.velocity), double(frame.angular_velocity), double(frame.mcl_x),
+                double(frame.mcl_y), double(frame.mcl_variance)})
+          {
+            columns[c++].values.push_back(value);
+          }
+          for (int i = 0; i < info.distance_count; i++)
+          {
+            columns[c++].values.push_back(frame.distance[i] / 100.0);
+          }
+          for (int i = 0; i < info.motor_count; i++)
+          {
+            columns[c++].values.push_back(frame.voltage[i]);
+            columns[c++].values.push_back(frame.current[i]);
+            columns[c++].values.push_back(frame.temperature[i]);
+          }
+          columns[c++].values.push_back(frame.battery_voltage);
+          columns[c++].values.push_back(frame.intake_state);
+          columns[c++].values.push_back((frame.flags & kMatchFlagBallDetected) ? 1 : 0);
+          rows++;
+        }
+        break;
+      }
+
+      case MatchBlockType::INDEX: index_blocks++; break;
+
+      default: std::fprintf(stderr, "unknown block type %u\n", header.type); break;
+    }
+  }
+  std::fclose(input);
+
+  if (!have_info)
+  {
+    std::fprintf(stderr, "no header block, is this a match recording?\n");
+    return 1;
+  }
+
+  // Row per frame CSV
+  std::string csv_path = std::string(argv[2]) + ".csv";
+  FILE* csv = std::fopen(csv_path.c_str(), "w");
+  if (csv == nullptr)
+  {
+    std::fprintf(stderr, "can't write %s\n", csv_path.c_str());
+    return 1;
+  }
+  for (size_t c = 0; c < columns.size(); c++)
+  {
+    std::fprintf(csv, "%s%s", c == 0 ? "" : ",", columns[c].name.c_str());
+  }
+  std::fprintf(csv, "\n");
+  for (size_t r = 0; r < rows; r++)
+  {
+    for (size_t c = 0; c < columns.size(); c++)
+    {
+      std::fprintf(csv, "%s%.9g", c == 0 ? "" : ",", columns[c].values[r]);
+    }
+    std::fprintf(csv, "\n");
+  }
+  std::fclose(csv);
+
+  // Column after column, so a single column can be read without touching the rest
+  std::string col_path = std::string(argv[2]) + ".col";
+  FILE* col = std::fopen(col_path.c_str(), "wb");
+  if (col == nullptr)
+  {
+    std::fprintf(stderr, "can't write %s\n", col_path.c_str());
+    return 1;
+  }
+  uint32_t column_count = columns.size();
+  uint32_t row_count = rows;
+  std::fwrite("MCOL", 1, 4, col);
+  std::fwrite(&column_count, sizeof(column_count), 1, col);
+  std::fwrite(&row_count, sizeof(row_count), 1, col);
+  for (const Column& column : columns)
+  {
+    uint8_t length = column.name.size();
+    std::fwrite(&length, 1, 1, col);
+    std::fwrite(column.name.data(), 1, length, col);
+  }
+  for (const Column& column : columns)
+  {
+    std::fwrite(column.values.data(), sizeof(double), column.values.size(), col);
+  }
+  std::fclose(col);
+
+  std::printf(
+      "%zu frames, %zu columns, %zu index blocks -> %s, %s\n",
+      rows,
+      columns.size(),
+      index_blocks,
+      csv_path.c_str(),
+      col_path.c_str());
+  return 0;
+}
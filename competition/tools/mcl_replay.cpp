@@ -0,0 +1,385 @@
+/**
+ * @file mcl_replay.cpp
+ * @author Andrew Hilton (2131N)
+ * @brief Host tool that replays match recordings through the MCL filter to tune it
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Build (from competition/):  g++ -std=c++20 -O2 -pthread -Iinclude tools/mcl_replay.cpp \
+ *                                 -o mcl_replay
+ * Usage:                      ./mcl_replay match_000.bin [options]
+ *
+ * Every option that takes a list is swept, each combination is replayed on its own thread:
+ *   --velocity-std 0.1,0.3      --angular-std 0.1,0.3     --roughening-std 0.005
+ *   --resample-alpha 0.5        --reinit-variance 14      --reset-threshold 1
+ *   --seeds 3                   Replays per combination, with seeds 0..N-1
+ *   --threads 8                 Worker threads (default: hardware threads)
+ *   --truth truth.csv           Reference poses as "timestamp,x,y" rows (ms, in), otherwise
+ *                               the recorded odometry is the reference
+ *
+ * Results are sorted by RMS error. "confident" is the share of frames the filter would have
+ * reset odometry on, "confident rms" the error on just those frames.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "2131N/systems/match_format.hpp"
+#include "2131N/systems/mcl/mcl_filter.hpp"
+#include "2131N/systems/mcl/sensor_mounts.hpp"
+
+static const DistanceModel kSensors[] = {
+    {kDistanceMounts[0].offset, kDistanceMounts[0].heading},
+    {kDistanceMounts[1].offset, kDistanceMounts[1].heading},
+    {kDistanceMounts[2].offset, kDistanceMounts[2].heading},
+    {kDistanceMounts[3].offset, kDistanceMounts[3].heading},
+};
+static constexpr size_t kSamples = 800;
+static constexpr double kOdometryJump = 6.0;  // Larger moves in one frame are odometry resets (in)
+
+struct ReplayFrame
+{
+  uint32_t timestamp;            // ms
+  Point position;                // Recorded odometry (in)
+  double heading;                // Recorded odometry (rad)
+  Point reference;               // Where the robot actually was (in)
+  double distance[kMatchMaxDistances];  // Distance readings, -1 if rejected (in)
+};
+
+struct ReplayResult
+{
+  MclSettings settings;
+  uint32_t seed;
+  double rms = 0.0;            // RMS error over every update (in)
+  double max = 0.0;            // Worst error (in)
+  double confident_rms = 0.0;  // RMS error over the updates that would reset odometry (in)
+  double confident = 0.0;      // Share of updates that would reset odometry
+  double update_us = 0.0;      // Mean time per update (us)
+};
+
+/**
+ * @brief Read every data frame out of a match recording
+ *
+ * @param path Recording
+ * @param frames Filled with the frames
+ * @param distance_count Set to the number of recorded distance sensors
+ * @return true Read at least a header
+ * @return false Not a match recording
+ */
+static bool readRecording(const char* path, std::vector<ReplayFrame>& frames, size_t& distance_count)
+{
+  FILE* input = std::fopen(path, "rb");
+  if (input == nullptr) { return false; }
+
+  bool have_info = false;
+  uint8_t block[kMatchBlockSize];
+  while (std::fread(block, kMatchBlockSize, 1, input) == 1)
+  {
+    MatchBlockHeader header;
+    std::memcpy(&header, block, sizeof(header));
+    if (header.magic != kMatchMagic || header.version != kMatchVersion) { break; }
+
+    if (header.type == static_cast<uint8_t>(MatchBlockType::HEADER))
+    {
+      MatchFileInfo info;
+      std::memcpy(&info, block + sizeof(header), sizeof(info));
+      if (info.frame_size != sizeof(MatchFrame)) { break; }
+      distance_count = std::min<size_t>(info.distance_count, std::size(kSensors));
+      have_info = true;
+    }
+    else if (header.type == static_cast<uint8_t>(MatchBlockType::DATA) && have_info)
+    {
+      for (size_t f = 0; f < header.count && f < kMatchFramesPerBlock; f++)
+      {
+        MatchFrame frame;
+        std::memcpy(&frame, block + sizeof(header) + f * sizeof(MatchFrame), sizeof(frame));
+
+        ReplayFrame replay{};
+        replay.timestamp = frame.timestamp;
+        replay.position = {frame.x, frame.y};
+        replay.heading = frame.theta * M_PI / 180.0;
+        replay.reference = replay.position;
+        for (size_t i = 0; i < kMatchMaxDistances; i++)
+        {
+          // The recorder stores rejected readings as 0
+          replay.distance[i] = frame.distance[i] == 0 ? -1.0 : frame.distance[i] / 100.0;
+        }
+        frames.push_back(replay);
+      }
+    }
+  }
+  std::fclose(input);
+  return have_info;
+}
+
+/**
+ * @brief Replace the reference poses with the closest earlier row of a truth file
+ *
+ * @param path CSV of timestamp,x,y rows
+ * @param frames Frames to update
+ * @return true Read the file
+ * @return false Couldn't open it
+ */
+static bool readTruth(const char* path, std::vector<ReplayFrame>& frames)
+{
+  FILE* input = std::fopen(path, "r");
+  if (input == nullptr) { return false; }
+
+  std::vector<std::pair<uint32_t, Point>> rows;
+  char line[256];
+  while (std::fgets(line, sizeof(line), input) != nullptr)
+  {
+    unsigned timestamp;
+    double x, y;
+    if (std::sscanf(line, "%u,%lf,%lf", &timestamp, &x, &y) == 3)
+    {
+      rows.push_back({timestamp, {x, y}});
+    }
+  }
+  std::fclose(input);
+  if (rows.empty()) { return true; }
+
+  size_t row = 0;
+  for (ReplayFrame& frame : frames)
+  {
+    while (row + 1 < rows.size() && rows[row + 1].first <= frame.timestamp) { row++; }
+    frame.reference = rows[row].second;
+  }
+  return true;
+}
+
+/**
+ * @brief Replay a recording through one filter
+ *
+ * @param frames Recording
+ * @param distance_count Distance sensors in the recording
+ * @param settings Filter tuning
+ * @param seed Filter seed
+ * @return ReplayResult Error and cost of the replay
+ */
+static ReplayResult replay(
+    const std::vector<ReplayFrame>& frames,
+    size_t distance_count,
+    const MclSettings& settings,
+    uint32_t seed)
+{
+  std::vector<DistanceModel> sensors(kSensors, kSensors + distance_count);
+  std::vector<DistanceModel*> sensor_pointers;
+  for (DistanceModel& sensor : sensors) { sensor_pointers.push_back(&sensor); }
+
+  // Heap allocated, the particle arrays are too big for a thread's stack
+  auto filter = std::make_unique<MclFilter<kSamples>>(
+      std::make_shared<Field>(Field(Point(1, 1), Point(143, 143))),
+      sensor_pointers,
+      settings,
+      seed);
+
+  ReplayResult result{settings, seed};
+  size_t updates = 0;
+  size_t confident = 0;
+  double squared_error = 0.0;
+  double confident_squared_error = 0.0;
+  double update_time = 0.0;
+
+  // The robot's own resets show up as jumps in its odometry, the replay makes its own instead
+  Point odometry_offset = {0, 0};
+  for (size_t f = 1; f < frames.size(); f++)
+  {
+    const ReplayFrame& last = frames[f - 1];
+    const ReplayFrame& frame = frames[f];
+
+    Point position_delta = frame.position - last.position;
+    double heading_delta = frame.heading - last.heading;
+    if (std::hypot(position_delta.x, position_delta.y) > kOdometryJump) { position_delta = {0, 0}; }
+    if (position_delta.x == 0.0 && position_delta.y == 0.0 && heading_delta == 0.0) { continue; }
+
+    odometry_offset += position_delta;
+    for (size_t i = 0; i < distance_count; i++)
+    {
+      sensors[i].update_pose(odometry_offset, frame.heading);
+      sensors[i].set_distance_reading(frame.distance[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool reset = filter->update(frame.heading, position_delta, heading_delta);
+    update_time +=
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+            .count();
+
+    Point estimate = filter->get_point_estimate();
+    Point error = estimate - frame.reference;
+    double squared = error.x * error.x + error.y * error.y;
+
+    updates++;
+    squared_error += squared;
+    result.max = std::max(result.max, std::sqrt(squared));
+    if (reset)
+    {
+      confident++;
+      confident_squared_error += squared;
+      odometry_offset = estimate;
+    }
+  }
+
+  if (updates > 0)
+  {
+    result.rms = std::sqrt(squared_error / updates);
+    result.confident = static_cast<double>(confident) / updates;
+    result.update_us = update_time / updates;
+  }
+  if (confident > 0) { result.confident_rms = std::sqrt(confident_squared_error / confident); }
+  return result;
+}
+
+/**
+ * @brief Parse a comma separated list of numbers
+ *
+ * @param text List
+ * @return std::vector<double> Values
+ */
+static std::vector<double> parseList(const char* text)
+{
+  std::vector<double> values;
+  char* end = nullptr;
+  for (const char* p = text; *p != '\0'; p = (*end == ',') ? end + 1 : end)
+  {
+    values.push_back(std::strtod(p, &end));
+    if (end == p) { break; }
+  }
+  return values;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::fprintf(stderr, "usage: %s <recording.bin> [options], see the source for options\n", argv[0]);
+    return 1;
+  }
+
+  MclSettings defaults;
+  std::vector<double> velocity_std{defaults.velocity_std};
+  std::vector<double> angular_std{defaults.angular_velocity_std};
+  std::vector<double> roughening_std{defaults.roughening_std};
+  std::vector<double> resample_alpha{defaults.resample_alpha};
+  std::vector<double> reinit_variance{defaults.reinitialize_variance};
+  std::vector<double> reset_threshold{defaults.odometry_reset_threshold};
+  uint32_t seeds = 1;
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  const char* truth = nullptr;
+
+  for (int i = 2; i + 1 < argc; i += 2)
+  {
+    std::string option = argv[i];
+    const char* value = argv[i + 1];
+    if (option == "--velocity-std") { velocity_std = parseList(value); }
+    else if (option == "--angular-std") { angular_std = parseList(value); }
+    else if (option == "--roughening-std") { roughening_std = parseList(value); }
+    else if (option == "--resample-alpha") { resample_alpha = parseList(value); }
+    else if (option == "--reinit-variance") { reinit_variance = parseList(value); }
+    else if (option == "--reset-threshold") { reset_threshold = parseList(value); }
+    else if (option == "--seeds") { seeds = std::max(1, std::atoi(value)); }
+    else if (option == "--threads") { threads = std::max(1, std::atoi(value)); }
+    else if (option == "--truth") { truth = value; }
+    else
+    {
+      std::fprintf(stderr, "unknown option %s\n", option.c_str());
+      return 1;
+    }
+  }
+
+  std::vector<ReplayFrame> frames;
+  size_t distance_count = 0;
+  if (!readRecording(argv[1], frames, distance_count))
+  {
+    std::fprintf(stderr, "can't read %s as a match recording\n", argv[1]);
+    return 1;
+  }
+  if (truth != nullptr && !readTruth(truth, frames))
+  {
+    std::fprintf(stderr, "can't open %s\n", truth);
+    return 1;
+  }
+
+  // Every combination of the swept values, each with every seed
+  std::vector<ReplayResult> runs;
+  for (double a : velocity_std)
+    for (double b : angular_std)
+      for (double c : roughening_std)
+        for (double d : resample_alpha)
+          for (double e : reinit_variance)
+            for (double g : reset_threshold)
+              for (uint32_t seed = 0; seed < seeds; seed++)
+              {
+                runs.push_back({{a, b, c, d, e, g}, seed});
+              }
+
+  std::printf(
+      "%zu frames, %zu distance sensors, %zu replays on %u threads\n",
+      frames.size(),
+      distance_count,
+      runs.size(),
+      threads);
+
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < std::min<size_t>(threads, runs.size()); t++)
+  {
+    workers.emplace_back([&]() {
+      for (size_t i = next.fetch_add(1); i < runs.size(); i = next.fetch_add(1))
+      {
+        runs[i] = replay(frames, distance_count, runs[i].settings, runs[i].seed);
+      }
+    });
+  }
+  for (std::thread& worker : workers) { worker.join(); }
+
+  std::sort(runs.begin(), runs.end(), [](const ReplayResult& a, const ReplayResult& b) {
+    return a.rms < b.rms;
+  });
+
+  std::printf(
+      "%8s %8s %8s %6s %7s %7s %4s | %8s %8s %9s %9s %9s\n",
+      "vel_std",
+      "ang_std",
+      "rough",
+      "alpha",
+      "reinit",
+      "reset",
+      "seed",
+      "rms",
+      "max",
+      "confident",
+      "conf_rms",
+      "update_us");
+  for (const ReplayResult& run : runs)
+  {
+    std::printf(
+        "%8.4g %8.4g %8.4g %6.3g %7.3g %7.3g %4u | %8.3f %8.3f %8.1f%% %9.3f %9.1f\n",
+        run.settings.velocity_std,
+        run.settings.angular_velocity_std,
+        run.settings.roughening_std,
+        run.settings.resample_alpha,
+        run.settings.reinitialize_variance,
+        run.settings.odometry_reset_threshold,
+        run.seed,
+        run.rms,
+        run.max,
+        run.confident * 100.0,
+        run.confident_rms,
+        run.update_us);
+  }
+  return 0;
+}
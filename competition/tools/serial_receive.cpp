@@ -0,0 +1,405 @@
+/**
+ * @file serial_receive.cpp
+ * @author Andrew Hilton (2131N)
+ * @brief Host receiver for the live serial telemetry stream
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Build (from competition/):  g++ -std=c++20 -O2 -pthread -Iinclude tools/serial_receive.cpp \
+ *                                 -o serial_receive
+ * Usage:                      ./serial_receive /dev/ttyACM1 run_01
+ *                             ./serial_receive --pty-test
+ *
+ * Writes <prefix>_pose.csv and <prefix>_particles.csv as packets arrive, and also prints pose
+ * rows on stdout so they can be piped straight into a plotter. Link stats go to stderr once a
+ * second. --pty-test plays a made up robot through a pseudo-terminal (with some line noise) and
+ * checks every pose comes out the other side, no robot needed.
+ */
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "2131N/systems/serial_format.hpp"
+
+struct ReceiverStats
+{
+  size_t bytes = 0;     // Bytes read
+  size_t frames = 0;    // Frames that passed the checksum
+  size_t damaged = 0;   // Frames that didn't
+  size_t lost = 0;      // Packets missing from the sequence
+  size_t unsynced = 0;  // Pose deltas thrown away while waiting for a key frame
+};
+
+class Receiver
+{
+ private:
+  FILE* pose_csv_;
+  FILE* particle_csv_;
+  bool echo_;  // Print pose rows on stdout
+
+  std::vector<uint8_t> frame_;  // Encoded bytes since the last delimiter
+  std::vector<uint8_t> packet_;
+
+  SerialPose pose_{};         // Last decoded pose
+  bool pose_synced_ = false;  // Has a key frame been seen since the last gap
+  int pose_sequence_ = -1;
+  int particle_sequence_ = -1;
+
+ public:
+  ReceiverStats stats;
+  std::vector<SerialPose> poses;  // Every pose decoded
+
+  Receiver(FILE* pose_csv, FILE* particle_csv, bool echo)
+      : pose_csv_(pose_csv), particle_csv_(particle_csv), echo_(echo), packet_(kSerialMaxPacket)
+  {
+    if (pose_csv_ != nullptr)
+    {
+      std::fprintf(pose_csv_, "timestamp,x,y,theta,velocity,angular_velocity\n");
+    }
+    if (particle_csv_ != nullptr)
+    {
+      std::fprintf(particle_csv_, "timestamp,estimate_x,estimate_y,variance,particle,x,y\n");
+    }
+  }
+
+  /**
+   * @brief Feed raw bytes from the port
+   *
+   * @param data Bytes
+   * @param length Number of bytes
+   */
+  void feed(const uint8_t* data, size_t length)
+  {
+    stats.bytes += length;
+    for (size_t i = 0; i < length; i++)
+    {
+      if (data[i] != 0)
+      {
+        // Anything longer than a packet can be is line noise
+        if (frame_.size() < cobsMaxEncodedSize(kSerialMaxPacket)) { frame_.push_back(data[i]); }
+        continue;
+      }
+
+      if (!frame_.empty())
+      {
+        size_t size = serialUnframe(frame_.data(), frame_.size(), packet_.data());
+        if (size == 0) { stats.damaged++; }
+        else { this->handle(packet_.data(), size); }
+        frame_.clear();
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief Count the packets missing before this one
+   *
+   * @param last Last sequence seen (-1 for none)
+   * @param sequence This packet's sequence
+   * @return size_t Packets missing
+   */
+  static size_t gap(int& last, uint8_t sequence)
+  {
+    size_t missing = last < 0 ? 0 : static_cast<uint8_t>(sequence - last - 1);
+    last = sequence;
+    return missing;
+  }
+
+  void handle(const uint8_t* packet, size_t length)
+  {
+    const uint8_t* in = packet + 2;
+    const uint8_t* end = packet + length;
+    bool key = packet[0] & kSerialKeyFrame;
+    SerialPacketType type = static_cast<SerialPacketType>(packet[0] & ~kSerialKeyFrame);
+    stats.frames++;
+
+    if (type == SerialPacketType::POSE)
+    {
+      size_t missing = gap(pose_sequence_, packet[1]);
+      stats.lost += missing;
+      if (missing > 0) { pose_synced_ = false; }
+
+      if (!key && !pose_synced_)
+      {
+        stats.unsynced++;
+        return;
+      }
+      if (!serialGetPose(in, end, pose_, key))
+      {
+        stats.damaged++;
+        return;
+      }
+      pose_synced_ = true;
+      poses.push_back(pose_);
+
+      double row[] = {
+          pose_.x / kSerialPositionScale,
+          pose_.y / kSerialPositionScale,
+          pose_.theta / kSerialHeadingScale,
+          pose_.velocity / kSerialVelocityScale,
+          pose_.angular_velocity / kSerialAngularScale};
+      for (FILE* out : {pose_csv_, echo_ ? stdout : nullptr})
+      {
+        if (out == nullptr) { continue; }
+        std::fprintf(
+            out,
+            "%d,%.2f,%.2f,%.2f,%.2f,%.3f\n",
+            pose_.timestamp,
+            row[0],
+            row[1],
+            row[2],
+            row[3],
+            row[4]);
+      }
+    }
+    else if (type == SerialPacketType::PARTICLES)
+    {
+      stats.lost += gap(particle_sequence_, packet[1]);
+
+      uint32_t timestamp, variance, count;
+      int32_t estimate_x, estimate_y;
+      if (!getVarint(in, end, timestamp) || !getSignedVarint(in, end, estimate_x) ||
+          !getSignedVarint(in, end, estimate_y) || !getVarint(in, end, variance) ||
+          !getVarint(in, end, count))
+      {
+        stats.damaged++;
+        return;
+      }
+
+      int32_t x = 0;
+      int32_t y = 0;
+      for (uint32_t i = 0; i < count; i++)
+      {
+        int32_t dx, dy;
+        if (!getSignedVarint(in, end, dx) || !getSignedVarint(in, end, dy))
+        {
+          stats.damaged++;
+          return;
+        }
+        x += dx;
+        y += dy;
+
+        if (particle_csv_ != nullptr)
+        {
+          std::fprintf(
+              particle_csv_,
+              "%u,%.2f,%.2f,%.3f,%u,%.1f,%.1f\n",
+              timestamp,
+              estimate_x / kSerialPositionScale,
+              estimate_y / kSerialPositionScale,
+              variance / kSerialVarianceScale,
+              i,
+              x / kSerialParticleScale,
+              y / kSerialParticleScale);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * @brief Put a port into raw mode so no bytes are translated or held back
+ *
+ * @param fd Port
+ */
+static void makeRaw(int fd)
+{
+  termios settings;
+  if (tcgetattr(fd, &settings) != 0) { return; }
+  cfmakeraw(&settings);
+  settings.c_cc[VMIN] = 1;
+  settings.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &settings);
+}
+
+/**
+ * @brief Stand in for the robot: the same packets SerialTelemetry sends, through a pty
+ *
+ * @return int 0 if every pose arrived intact
+ */
+static int ptyTest()
+{
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+  {
+    std::fprintf(stderr, "can't open a pseudo-terminal\n");
+    return 1;
+  }
+  int port = open(ptsname(master), O_RDONLY | O_NOCTTY);
+  if (port < 0)
+  {
+    std::fprintf(stderr, "can't open %s\n", ptsname(master));
+    return 1;
+  }
+  makeRaw(port);
+  makeRaw(master);
+
+  constexpr int kPoses = 1000;
+  std::vector<SerialPose> sent;
+
+  std::thread robot([&]() {
+    SerialPose last{};
+    uint8_t packet[kSerialMaxPacket];
+    uint8_t frame[cobsMaxEncodedSize(kSerialMaxPacket) + 2];
+    uint8_t particle_sequence = 0;
+
+    for (int i = 0; i < kPoses; i++)
+    {
+      double t = i * 0.01;
+      SerialPose pose{
+          i * 10,
+          serialQuantize(72 + 30 * std::sin(t), kSerialPositionScale),
+          serialQuantize(72 - 30 * std::cos(t), kSerialPositionScale),
+          serialQuantize(std::fmod(t * 180 / M_PI + 90, 360), kSerialHeadingScale),
+          serialQuantize(30.0, kSerialVelocityScale),
+          serialQuantize(1.0, kSerialAngularScale)};
+      bool key = i % kSerialKeyInterval == 0;
+
+      uint8_t* out = packet;
+      *out++ = static_cast<uint8_t>(SerialPacketType::POSE) | (key ? kSerialKeyFrame : 0);
+      *out++ = static_cast<uint8_t>(i);
+      serialPutPose(out, pose, last, key);
+      last = pose;
+      sent.push_back(pose);
+      size_t size = serialFrame(packet, out - packet, frame);
+      if (write(master, frame, size) != static_cast<ssize_t>(size)) { return; }
+
+      // A stray print in the middle of the stream
+      if (i == 100)
+      {
+        const char* text = "printf from some other task\n";
+        if (write(master, text, std::strlen(text)) < 0) { return; }
+      }
+
+      if (i % 20 == 0)
+      {
+        out = packet;
+        *out++ = static_cast<uint8_t>(SerialPacketType::PARTICLES) | kSerialKeyFrame;
+        *out++ = particle_sequence++;
+        putVarint(out, i * 10);
+        putSignedVarint(out, pose.x);
+        putSignedVarint(out, pose.y);
+        putVarint(out, 500);
+        putVarint(out, 64);
+        for (int p = 0; p < 64; p++)
+        {
+          putSignedVarint(out, p == 0 ? 100 : 7);
+          putSignedVarint(out, p == 0 ? 700 : (p % 2 ? 15 : -12));
+        }
+        size = serialFrame(packet, out - packet, frame);
+        if (write(master, frame, size) != static_cast<ssize_t>(size)) { return; }
+      }
+    }
+
+    // Flush the last frame through with one more delimiter
+    uint8_t zero = 0;
+    if (write(master, &zero, 1) < 0) { return; }
+  });
+
+  Receiver receiver(nullptr, nullptr, false);
+  uint8_t buffer[4096];
+  auto start = std::chrono::steady_clock::now();
+  while (receiver.poses.size() < kPoses &&
+         std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+  {
+    ssize_t length = read(port, buffer, sizeof(buffer));
+    if (length <= 0) { break; }
+    receiver.feed(buffer, length);
+  }
+  robot.join();
+  close(port);
+  close(master);
+
+  size_t mismatched = 0;
+  for (size_t i = 0; i < receiver.poses.size() && i < sent.size(); i++)
+  {
+    if (std::memcmp(&receiver.poses[i], &sent[i], sizeof(SerialPose)) != 0) { mismatched++; }
+  }
+
+  std::printf(
+      "%zu/%d poses, %zu mismatched, %zu frames, %zu damaged, %zu lost, %.1f bytes per pose\n",
+      receiver.poses.size(),
+      kPoses,
+      mismatched,
+      receiver.stats.frames,
+      receiver.stats.damaged,
+      receiver.stats.lost,
+      static_cast<double>(receiver.stats.bytes) / kPoses);
+  return receiver.poses.size() == kPoses && mismatched == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc == 2 && std::strcmp(argv[1], "--pty-test") == 0) { return ptyTest(); }
+  if (argc != 3)
+  {
+    std::fprintf(stderr, "usage: %s <port> <output prefix> | --pty-test\n", argv[0]);
+    return 1;
+  }
+
+  int port = open(argv[1], O_RDONLY | O_NOCTTY);
+  if (port < 0)
+  {
+    std::fprintf(stderr, "can't open %s\n", argv[1]);
+    return 1;
+  }
+  makeRaw(port);
+
+  std::string prefix = argv[2];
+  FILE* pose_csv = std::fopen((prefix + "_pose.csv").c_str(), "w");
+  FILE* particle_csv = std::fopen((prefix + "_particles.csv").c_str(), "w");
+  if (pose_csv == nullptr || particle_csv == nullptr)
+  {
+    std::fprintf(stderr, "can't write %s_*.csv\n", argv[2]);
+    return 1;
+  }
+
+  Receiver receiver(pose_csv, particle_csv, true);
+  ReceiverStats last{};
+  auto last_report = std::chrono::steady_clock::now();
+
+  uint8_t buffer[4096];
+  while (true)
+  {
+    ssize_t length = read(port, buffer, sizeof(buffer));
+    if (length <= 0) { break; }
+    receiver.feed(buffer, length);
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_report >= std::chrono::seconds(1))
+    {
+      const ReceiverStats& stats = receiver.stats;
+      std::fprintf(
+          stderr,
+          "%zu B/s, %zu frames/s, %zu damaged, %zu lost, %zu unsynced\n",
+          stats.bytes - last.bytes,
+          stats.frames - last.frames,
+          stats.damaged - last.damaged,
+          stats.lost - last.lost,
+          stats.unsynced - last.unsynced);
+      std::fflush(stdout);
+      std::fflush(pose_csv);
+      std::fflush(particle_csv);
+      last = stats;
+      last_report = now;
+    }
+  }
+
+  std::fclose(pose_csv);
+  std::fclose(particle_csv);
+  close(port);
+  return 0;
+}
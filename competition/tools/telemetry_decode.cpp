@@ -0,0 +1,350 @@
+/**
+ * @file telemetry_decode.cpp
+ * @author Andrew Hilton (2131N)
+ * @brief Host tool that converts telemetry streams to CSV and formats their log messages
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * Build (from competition/):  g++ -std=c++20 -O2 -Iinclude tools/telemetry_decode.cpp \
+ *                                 -o telemetry_decode
+ * Usage:                      ./telemetry_decode telemetry_000.bin telemetry_000
+ *                             ./telemetry_decode --self-test
+ *
+ * Writes <prefix>_odometry.csv, <prefix>_mcl.csv and <prefix>_intake.csv (one row per record)
+ * and <prefix>_messages.txt, and prints the messages on stdout as well. Sequence gaps (records
+ * the brain dropped) go to stderr. --self-test decodes a made up stream and checks the messages
+ * come out formatted, no robot needed.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+#include "2131N/systems/telemetry_format.hpp"
+#include "2131N/utils/deferred_format.hpp"
+
+namespace
+{
+constexpr const char* kLevelNames[] = {"INFO", "DEBUG", "WARN", "ERROR", "FATAL"};  // lemlib::Level
+constexpr size_t kMessageSlot = static_cast<size_t>(TelemetryChannel::COUNT);  // After sampled
+
+/**
+ * @brief Format definitions rebuilt from FORMAT records
+ *
+ */
+class FormatTable
+{
+ private:
+  std::array<std::string, DeferredFormatRegistry::kMaxFormats> definitions_;
+
+ public:
+  void add(const TelemetryFormatChunk& chunk)
+  {
+    if (chunk.format >= definitions_.size()) { return; }
+
+    std::string& definition = definitions_[chunk.format];
+    if (definition.size() < chunk.offset + sizeof(chunk.text))
+    {
+      definition.resize(chunk.offset + sizeof(chunk.text), '\0');
+    }
+    definition.replace(chunk.offset, sizeof(chunk.text), chunk.text, sizeof(chunk.text));
+  }
+
+  /**
+   * @brief Format a message
+   *
+   * @param message Message record payload
+   * @return std::string Text, or a placeholder if its definition never arrived
+   */
+  std::string format(const TelemetryMessage& message) const
+  {
+    if (message.format >= definitions_.size() || definitions_[message.format].empty())
+    {
+      return "<format " + std::to_string(message.format) + " missing>";
+    }
+
+    // "<signature>\0<format>\0"
+    const std::string& definition = definitions_[message.format];
+    const char* signature = definition.c_str();
+    const char* format = signature + std::strlen(signature) + 1;
+
+    char text[256];
+    formatDeferred(
+        format,
+        signature,
+        message.args,
+        std::min<size_t>(message.size, sizeof(message.args)),
+        text,
+        sizeof(text));
+    return text;
+  }
+};
+
+struct Output
+{
+  FILE* odometry;
+  FILE* mcl;
+  FILE* intake;
+  FILE* messages;
+  bool echo;  // Print messages on stdout
+};
+
+/**
+ * @brief Decode a stream
+ *
+ * @param input Stream, positioned at its header
+ * @param output Where the rows and messages go
+ * @return size_t Records decoded, 0 if the stream isn't telemetry
+ */
+size_t decode(FILE* input, const Output& output)
+{
+  TelemetryHeader header;
+  TelemetryHeader expected;
+  if (std::fread(&header, sizeof(header), 1, input) != 1 ||
+      std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0)
+  {
+    std::fprintf(stderr, "no TLM1 header, is this a telemetry stream?\n");
+    return 0;
+  }
+  if (header.record_size != sizeof(TelemetryRecord))
+  {
+    std::fprintf(stderr, "record size %u doesn't match this decoder\n", header.record_size);
+    return 0;
+  }
+
+  std::fprintf(output.odometry, "timestamp,x,y,theta,velocity,angular_velocity\n");
+  std::fprintf(output.mcl, "timestamp,x,y,variance\n");
+  std::fprintf(
+      output.intake,
+      "timestamp,state,ball_detected,anti_jam,bottom_voltage,middle_voltage,top_voltage\n");
+
+  FormatTable formats;
+  std::array<int, kMessageSlot + 1> last_sequence;  // Last sequence seen per channel
+  last_sequence.fill(-1);
+  size_t records = 0;
+
+  TelemetryRecord record;
+  while (std::fread(&record, sizeof(record), 1, input) == 1)
+  {
+    records++;
+    auto channel = static_cast<TelemetryChannel>(record.channel);
+
+    // Messages share one sequence across tasks, sampled channels have one each
+    size_t slot = channel == TelemetryChannel::MESSAGE ? kMessageSlot : record.channel;
+    if (slot < last_sequence.size())
+    {
+      uint16_t expected_sequence = static_cast<uint16_t>(last_sequence[slot] + 1);
+      if (last_sequence[slot] >= 0 && record.sequence != expected_sequence)
+      {
+        std::fprintf(
+            stderr,
+            "channel %u: %u records dropped before %u ms\n",
+            record.channel,
+            static_cast<uint16_t>(record.sequence - expected_sequence),
+            record.timestamp);
+      }
+      last_sequence[slot] = record.sequence;
+    }
+
+    switch (channel)
+    {
+      case TelemetryChannel::ODOMETRY:
+      {
+        TelemetryPayload<TelemetryChannel::ODOMETRY> odometry;
+        std::memcpy(&odometry, record.payload, sizeof(odometry));
+        std::fprintf(
+            output.odometry,
+            "%u,%.9g,%.9g,%.9g,%.9g,%.9g\n",
+            record.timestamp,
+            odometry.x,
+            odometry.y,
+            odometry.theta,
+            odometry.velocity,
+            odometry.angular_velocity);
+        break;
+      }
+
+      case TelemetryChannel::MCL:
+      {
+        TelemetryPayload<TelemetryChannel::MCL> mcl;
+        std::memcpy(&mcl, record.payload, sizeof(mcl));
+        std::fprintf(
+            output.mcl, "%u,%.9g,%.9g,%.9g\n", record.timestamp, mcl.x, mcl.y, mcl.variance);
+        break;
+      }
+
+      case TelemetryChannel::INTAKE:
+      {
+        TelemetryPayload<TelemetryChannel::INTAKE> intake;
+        std::memcpy(&intake, record.payload, sizeof(intake));
+        std::fprintf(
+            output.intake,
+            "%u,%u,%u,%u,%d,%d,%d\n",
+            record.timestamp,
+            intake.state,
+            intake.ball_detected,
+            intake.anti_jam,
+            intake.bottom_voltage,
+            intake.middle_voltage,
+            intake.top_voltage);
+        break;
+      }
+
+      case TelemetryChannel::FORMAT:
+      {
+        TelemetryFormatChunk chunk;
+        std::memcpy(&chunk, record.payload, sizeof(chunk));
+        formats.add(chunk);
+        break;
+      }
+
+      case TelemetryChannel::MESSAGE:
+      {
+        TelemetryMessage message;
+        std::memcpy(&message, record.payload, sizeof(message));
+
+        const char* level =
+            message.level < std::size(kLevelNames) ? kLevelNames[message.level] : "?";
+        std::string text = formats.format(message);
+        std::fprintf(output.messages, "%u [%s] %s\n", record.timestamp, level, text.c_str());
+        if (output.echo) { std::printf("%u [%s] %s\n", record.timestamp, level, text.c_str()); }
+        break;
+      }
+
+      default: std::fprintf(stderr, "unknown channel %u\n", record.channel); break;
+    }
+  }
+
+  return records;
+}
+
+/**
+ * @brief Write a record the way the brain's drain does
+ *
+ * @param file Stream
+ * @param channel Channel
+ * @param time Timestamp (ms)
+ * @param sequence Sequence
+ * @param payload Payload
+ * @param size Bytes of payload
+ */
+void writeRecord(
+    FILE* file,
+    TelemetryChannel channel,
+    uint32_t time,
+    uint16_t sequence,
+    const void* payload,
+    size_t size)
+{
+  TelemetryRecord record{};
+  record.timestamp = time;
+  record.channel = static_cast<uint8_t>(channel);
+  record.size = size;
+  record.sequence = sequence;
+  std::memcpy(record.payload, payload, size);
+  std::fwrite(&record, sizeof(record), 1, file);
+}
+
+/**
+ * @brief Decode a made up stream with a message split over two FORMAT records
+ *
+ * @return int 0 if the message came out right
+ */
+int selfTest()
+{
+  FILE* stream = std::tmpfile();
+  TelemetryHeader header;
+  std::fwrite(&header, sizeof(header), 1, stream);
+
+  // "fi\0<format>\0" is 35 bytes, so it takes two chunks
+  const char signature[] = "fi";
+  const char format[] = "Stage {1} jammed at {0:.1f} rpm";
+  std::string definition = std::string(signature) + '\0' + format + '\0';
+  for (size_t offset = 0; offset < definition.size(); offset += sizeof(TelemetryFormatChunk::text))
+  {
+    TelemetryFormatChunk chunk{};
+    chunk.format = 3;
+    chunk.offset = offset;
+    definition.copy(chunk.text, sizeof(chunk.text), offset);
+    writeRecord(stream, TelemetryChannel::FORMAT, 1000, 0, &chunk, sizeof(chunk));
+  }
+
+  TelemetryMessage message{};
+  message.format = 3;
+  message.level = 2;
+  uint8_t* out = message.args;
+  packDeferredArg(out, 12.5f);
+  packDeferredArg(out, 1);
+  message.size = out - message.args;
+  writeRecord(stream, TelemetryChannel::MESSAGE, 1000, 0, &message, sizeof(message));
+
+  TelemetryPayload<TelemetryChannel::MCL> mcl{1.0f, 2.0f, 0.5f};
+  writeRecord(stream, TelemetryChannel::MCL, 1010, 0, &mcl, sizeof(mcl));
+  writeRecord(stream, TelemetryChannel::MCL, 1040, 3, &mcl, sizeof(mcl));
+  std::rewind(stream);
+
+  FILE* messages = std::tmpfile();
+  FILE* discard = std::tmpfile();
+  size_t records = decode(stream, {discard, discard, discard, messages, false});
+
+  char line[256] = {};
+  std::rewind(messages);
+  std::fgets(line, sizeof(line), messages);
+  bool passed = records == 5 && std::strcmp(line, "1000 [WARN] Stage 1 jammed at 12.5 rpm\n") == 0;
+
+  std::printf("%zu records, message: %s%s\n", records, line, passed ? "passed" : "FAILED");
+  std::fclose(stream);
+  std::fclose(messages);
+  std::fclose(discard);
+  return passed ? 0 : 1;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc == 2 && std::strcmp(argv[1], "--self-test") == 0) { return selfTest(); }
+  if (argc != 3)
+  {
+    std::fprintf(stderr, "usage: %s <telemetry.bin> <output prefix>\n", argv[0]);
+    std::fprintf(stderr, "       %s --self-test\n", argv[0]);
+    return 1;
+  }
+
+  FILE* input = std::fopen(argv[1], "rb");
+  if (input == nullptr)
+  {
+    std::fprintf(stderr, "can't open %s\n", argv[1]);
+    return 1;
+  }
+
+  std::string prefix = argv[2];
+  Output output{
+      std::fopen((prefix + "_odometry.csv").c_str(), "w"),
+      std::fopen((prefix + "_mcl.csv").c_str(), "w"),
+      std::fopen((prefix + "_intake.csv").c_str(), "w"),
+      std::fopen((prefix + "_messages.txt").c_str(), "w"),
+      true};
+  if (!output.odometry || !output.mcl || !output.intake || !output.messages)
+  {
+    std::fprintf(stderr, "can't write %s_*\n", prefix.c_str());
+    return 1;
+  }
+
+  size_t records = decode(input, output);
+  std::fclose(input);
+  for (FILE* file : {output.odometry, output.mcl, output.intake, output.messages})
+  {
+    std::fclose(file);
+  }
+
+  if (records == 0) { return 1; }
+  std::fprintf(stderr, "%zu records\n", records);
+  return 0;
+}